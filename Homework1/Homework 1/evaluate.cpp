@@ -8,209 +8,126 @@
 // -- simple arithmetic operators ( +, -, *, /, % )
 // -- matched parentheses for grouping
 
-// This implementation consists of a set of mutually-recursive 
-// functions. which will track the structure of the expression.
+// This implementation makes a single pass over the characters,
+// using two small stacks -- one of values, one of operators.
 //
-// A sum expression is the sum or difference of one or more products.
-// A product expression is the product or quotient of one or more factors.
-// A factor may be a number or a parenthesized sum expression.
+// Each value is pushed as it is found.  Before an operator is pushed,
+// every operator on the stack that should be done first (one of equal
+// or higher precedence, since all are left-associative) is applied
+// to the values beneath it.  A parenthesis holds back the operators
+// before it until the matching one closes it.
+//
+// So the stacks never hold more than a couple of operators for each
+// level of parentheses, however long the expression, and every
+// character is looked at just once.  Nothing is allocated.
 
 #include "tokenize.h"
 
-int evalUntilCharFound(const char expr[], int& pos, char end);
-int handleParenthesis(const char expr[], int& pos);
-int handleMultiplyLevelOperation(const char expr[], int& pos, int curr);
-int handleAdditionLevelOperation(const char expr[], int& pos, int curr);
-bool isNextOperatorMultiplication(const char expr[], int pos);
-int getValue(const char expr[], int& pos, bool evalMultiplication);
+const int MAX_NESTING = 100;                    // deepest parentheses allowed
+const int STACK_SIZE = 3 * (MAX_NESTING + 1);   // '(' and two operators a level
+
+static int precedence(char oper);
+static void applyOperator(int values[], int& numValues, char opers[], int& numOpers);
 
 // evaluate
 // Evaluates the entire expression
 // Parameters:
 //     expression (input string) the expression to evaluate
 // Pre-condition: String ends with \0
-// Return: Value of the expression
+// Return: Value of the expression (or 0 if it is empty, or nested too deeply)
 int evaluate(const char expression[])
 {
+    int values[STACK_SIZE];         // values not yet used up
+    char opers[STACK_SIZE];         // operators not yet applied
+    int numValues = 0,
+        numOpers  = 0;
+
     int pos;
     findFirstToken(expression, pos);
 
-    return evalUntilCharFound(expression, pos, '\0');
-}
-
-// evalUntilCharFound
-// Evaluates the expression until it finds a given character
-// Parameters:
-//     expr (input        string)    expression to evaluate
-//     pos  (input/output integer)   position to start at
-//     end  (input        character) charater denoting end of evaluation
-// Pre-condition:  pos is at a token
-// Post-condition: expr[pos] == end
-// Return: Value of the expression from pos to end
-int evalUntilCharFound(const char expr[], int& pos, char end)
-{
-    int curr_value = getValue(expr, pos, false); //Do not handle multiplication (see getValue())
-
-    while (currentToken(expr, pos) != end)
+    for (char token; (token = currentToken(expression, pos)) != '\0'; advance(expression, pos))
     {
-        advance(expr, pos);
-        switch (currentToken(expr, pos))
+        if (currentIsInteger(expression, pos))
+        {
+            values[numValues++] = integerValue(expression, pos);
+        }
+        else if (token == ')')
         {
-        case '*':
-        case '/':
-        case '%':
-            curr_value = handleMultiplyLevelOperation(expr, pos, curr_value);
-            break;
-        case '+':
-        case '-':
-            curr_value = handleAdditionLevelOperation(expr, pos, curr_value);
-            break;
+            while (opers[numOpers-1] != '(')
+                applyOperator(values, numValues, opers, numOpers);
+            --numOpers;             // the '(' itself
+        }
+        else
+        {
+            if (numOpers + 3 > STACK_SIZE)
+                return 0;           // too deeply nested to hold
+            while (token != '(' && numOpers > 0 &&
+                    precedence(opers[numOpers-1]) >= precedence(token))
+                applyOperator(values, numValues, opers, numOpers);
+            opers[numOpers++] = token;
         }
     }
 
-    return curr_value;
-}
-
-// handleParenthesis
-// Helper function to handle evaluating parenthesis
-// Parameters:
-//     expr (input        string)  expression being evaluated
-//     pos  (input/output integer) current position of evaluation
-// Pre-condition:  expr[pos] == '('
-// Post-condition: expr[pos] == ')'
-// Return: Value of expression inside parenthesis
-int handleParenthesis(const char expr[], int& pos)
-{
-    advance(expr, pos);
-    return evalUntilCharFound(expr, pos, ')');
-}
-
-// handleMultiplyLevelOperation
-// Handles * and /
-// Parameters:
-//     expr (input        string)  expression being evaluated
-//     pos  (input/output integer) current position of evaluation
-//     curr (input        integer) current value, i.e., the value of what's before the operator
-// Pre-condition:  expr[pos] == '*' or '/'
-// Post-condition: expr[pos] == end of what was multiplied (last int/parenthesis)
-// Return: value of the operation
-int handleMultiplyLevelOperation(const char expr[], int& pos, int curr)
-{
-    char operation = currentToken(expr, pos);
-
-    advance(expr, pos);
-
-    int nextValue = getValue(expr, pos, false); //Do not handle multiplication (see getValue())
-
-    if (operation == '*')
-    {
-        curr *= nextValue;
-    }
-    else if (operation == '/')
-    {
-        curr /= nextValue;
-    }
-    else
-    {
-        curr %= nextValue;
-    }
+    while (numOpers > 0)
+        applyOperator(values, numValues, opers, numOpers);
 
-    return curr;
+    if (numValues == 0)
+        return 0;                   // a blank line
+    return values[0];
 }
 
-//At current operation. Curr -> everything before it. End on end of last part.
-// handleAdditionLevelOperation
-// Handles +, -, and %
+// precedence
+// Ranks an operator on the stack
 // Parameters:
-//     expr (input        string)  expression being evaluated
-//     pos  (input/output integer) current position of evaluation
-//     curr (input        integer) current value, i.e., the value of what's before the operator
-// Pre-condition:  expr[pos] == '+', '-', or '%'
-// Post-condition: expr[pos] == end of what was multiplied (last int/parenthesis)
-// Return: value of the operation
-int handleAdditionLevelOperation(const char expr[], int& pos, int curr)
+//     oper (input character) the operator
+// Return: 2 for * / %, 1 for + -, or 0 for '(' (which is never applied)
+static int precedence(char oper)
 {
-    char operation = currentToken(expr, pos);
-
-    advance(expr, pos);
-
-    int valueToAdd = getValue(expr, pos, true); //Do evaluate multiplication (see getValue())
-
-    if (operation == '+')
+    switch (oper)
     {
-        curr += valueToAdd;
-    }
-    else
-    {
-        curr -= valueToAdd;
+    case '*':
+    case '/':
+    case '%':
+        return 2;
+    case '+':
+    case '-':
+        return 1;
+    default:
+        return 0;
     }
-
-    return curr;
 }
 
-// isNextOperatorMultiplication
-// Checks if the next operation in the expression has multiplication precedence
-// This is used to ensure multiplication is handled before addition
+// applyOperator
+// Applies the operator at the top of the operator stack to the
+// two values at the top of the value stack, leaving the result there
 // Parameters:
-//     expr (input string)  expression being evaluated
-//     pos  (input integer) current position of evaluation
-// Pre-condition:  expr[pos] is an integer
-// Return: whether the next operation is multiplication
-bool isNextOperatorMultiplication(const char expr[], int pos)
+//     values    (modified integer array)   the value stack
+//     numValues (modified integer)         how many values it holds
+//     opers     (modified character array) the operator stack
+//     numOpers  (modified integer)         how many operators it holds
+// Pre-condition:  there are at least two values, and an operator
+static void applyOperator(int values[], int& numValues, char opers[], int& numOpers)
 {
-    bool isMultiplication;
-    advance(expr, pos);
+    char operation = opers[--numOpers];
+    int right = values[--numValues];
+    int& left = values[numValues-1];
 
-    switch (currentToken(expr, pos))
+    switch (operation)
     {
     case '*':
+        left *= right;
+        break;
     case '/':
+        left /= right;
+        break;
     case '%':
-        isMultiplication = true;
+        left %= right;
+        break;
+    case '+':
+        left += right;
         break;
     default:
-        isMultiplication = false;
+        left -= right;
         break;
     }
-
-    return isMultiplication;
-}
-
-// getValue
-// Gets the value of the number/expression at the current position
-// If the current value is an integer, return it
-// If it's a parenthetical expression, evaluate, and return
-// evalMultiplication is a flag used to ensure multiplication happens before addition
-// If true, it will handle any multiplication that is applied to the current value
-// That way, what is returned to the addition function is what we actually want to add
-// Parameters:
-//     expr (input string) the expression being evaluated
-//     pos  (intput/output integer) the current position of evaluation
-//     evalMultiplication (input boolean) whether to evaluate multiplication, see above
-// Pre-condition:  expr[pos] is an int or parenthesis
-// Post-condition: expr[pos] is the end of the value
-//                 If it was an int, it's on the int
-//                 If it was a parenthesis, it's on the end parenthesis
-//                 If handling multiplication, it's on the last multiplied int
-// Return: value of int/expression
-int getValue(const char expr[], int& pos, bool evalMultiplication)
-{
-    int value;
-
-    if (currentIsInteger(expr, pos))
-    {
-        value = integerValue(expr, pos);
-
-        while (evalMultiplication && isNextOperatorMultiplication(expr, pos))
-        {
-            advance(expr, pos);
-            value = handleMultiplyLevelOperation(expr, pos, value);
-        }
-    }
-    else
-    {
-        value = handleParenthesis(expr, pos);
-    }
-
-    return value;
 }
@@ -72,5 +72,5 @@ bool currentIsInteger( const char expr[], int pos  )
 // Pre-condition: the character actually is indeed a numeric digit
 int integerValue( const char expr[], int pos )
 {
-    return atoi( &expr[pos] );
+    return expr[pos] - '0';
 }
@@ -4,7 +4,7 @@
 // and operands, it will evaluate that expression and return its value.
 //
 // The expressions may consist of the following:
-// -- single-digit integer values
+// -- integer values (which may have multiple digits)
 // -- simple arithmetic operators ( +, -, *, /, % )
 // -- matched parentheses for grouping
 
@@ -13,7 +13,13 @@
 //
 // A sum expression is the sum or difference of one or more products.
 // A product expression is the product or quotient of one or more factors.
-// A factor may be a number or a parenthesized sum expression.
+// A factor may be a number or a parenthesized sum expression,
+// either of which may be negated.
+//
+// Each function starts on the first token of what it evaluates, and
+// stops on the token just after it -- so that token is the only one
+// ever looked at in advance.  The iterator is never copied or moved
+// backward, and each token is visited just once.
 
 //I really shouldn't have to add these two lines here so tokenlist.h will build
 //Too bad I'm not allowed to change it
@@ -22,12 +28,9 @@ using namespace std;
 
 #include "tokenlist.h"
 
-void evalStep(ListIterator& iter, int& value);
-int  handleParenthesis(ListIterator& iter);
-void handleMultiplyLevelOperation(ListIterator& iter, int& curr);
-void handleAdditionLevelOperation(ListIterator& iter, int& curr);
-bool isNextOperatorMultiplication(ListIterator iter);
-int  getValue(ListIterator& iter, bool evalMultiplication);
+int sumValue(ListIterator& iter);
+int productValue(ListIterator& iter);
+int factorValue(ListIterator& iter);
 
 // evaluate
 // Evaluates the entire expression
@@ -39,186 +42,98 @@ int evaluate(const char expression[])
     TokenList expr(expression);
     ListIterator iter = expr.begin();
 
-    int value = getValue(iter,false);
-    
-    while (iter != expr.end())
-    {
-        evalStep(iter, value);
-    }
-
-    return value;
-}
-
-// evalStep
-// Evaluates the current operator
-// Parameters:
-//     iter  - the iterator for the list of tokens
-//     value - the running total for the expression
-// Pre-condition: Next token is an operator (although, it will just advance if it isn't)
-// Post-condition: New value stored in value
-//                 Iter is on the last token evaluated in this step (so iter.advance() next time will
-//                     bring it to the next thing to be evaluated)
-void evalStep(ListIterator& iter, int& value)
-{
-    iter.advance();
-    switch (iter.tokenChar())
-    {
-    case '*':
-    case '/':
-    case '%':
-        handleMultiplyLevelOperation(iter, value);
-        break;
-    case '+':
-    case '-':
-        handleAdditionLevelOperation(iter, value);
-        break;
-    }
+    return sumValue(iter);
 }
 
-// handleParenthesis
-// Helper function to handle evaluating parenthesis
+// sumValue
+// Evaluates a sum expression
 // Parameters:
 //     iter  - the iterator for the list of tokens
-// Pre-condition:  iter.tokenChar() == '('
-// Post-condition: iter.tokenChar() == ')'
-// Return: Value of expression inside parenthesis
-int handleParenthesis(ListIterator& iter)
+// Pre-condition:  iter is on the first token of the sum
+// Post-condition: iter is on the first token after it (such as ')' or the end)
+// Return: value of the sum
+int sumValue(ListIterator& iter)
 {
-    iter.advance();
-
-    int value = getValue(iter, false);
+    int value = productValue(iter);
 
-    while (iter.tokenChar() != ')')
+    for (char operation = iter.tokenChar(); operation == '+' || operation == '-'; operation = iter.tokenChar())
     {
-        evalStep(iter, value);
+        iter.advance();
+        int valueToAdd = productValue(iter);
+
+        if (operation == '+')
+        {
+            value += valueToAdd;
+        }
+        else
+        {
+            value -= valueToAdd;
+        }
     }
 
     return value;
 }
 
-// handleMultiplyLevelOperation
-// Handles *, /, and %
-// Parameters:
-//     iter  - the iterator for the list of tokens
-//     curr  - current running total to be multiplied by the next value
-// Pre-condition:  iter.tokenChar() == '*' or '/' or '%'
-// Post-condition: iter.tokenChar() == end of what was multiplied (last int/parenthesis)
-// Return: value of the operation
-void handleMultiplyLevelOperation(ListIterator& iter, int& curr)
-{
-    char operation = iter.tokenChar();
-    iter.advance();
-
-    int nextValue = getValue(iter, false); //Do not handle multiplication (see getValue())
-
-    if (operation == '*')
-    {
-        curr *= nextValue;
-    }
-    else if (operation == '/')
-    {
-        curr /= nextValue;
-    }
-    else
-    {
-        curr %= nextValue;
-    }
-}
-
-// handleMultiplyLevelOperation
-// Handles + and -
+// productValue
+// Evaluates a product expression
 // Parameters:
 //     iter  - the iterator for the list of tokens
-//     curr  - current running total to add the next value to
-// Pre-condition:  iter.tokenChar() == '+' or '-'
-// Post-condition: iter.tokenChar() == end of what was added (last int/parenthesis)
-// Return: value of the operation
-void handleAdditionLevelOperation(ListIterator& iter, int& curr)
+// Pre-condition:  iter is on the first token of the product
+// Post-condition: iter is on the first token after it
+// Return: value of the product
+int productValue(ListIterator& iter)
 {
-    char operation = iter.tokenChar();
-    iter.advance();
-
-    int valueToAdd = getValue(iter, true); //Do evaluate multiplication (see getValue())
+    int value = factorValue(iter);
 
-    if (operation == '+')
-    {
-        curr += valueToAdd;
-    }
-    else
+    for (char operation = iter.tokenChar(); operation == '*' || operation == '/' || operation == '%'; operation = iter.tokenChar())
     {
-        curr -= valueToAdd;
-    }
-}
-
-// isNextOperatorMultiplication
-// Checks if the next operation in the expression has multiplication precedence
-// This is used to ensure multiplication is handled before addition
-// Parameters:
-//     iter - the iterator for the list of tokens - not sent by reference, as in the other
-//            functions, so that we can look ahead without having to go back again.
-// Pre-condition: Next token is an operator (although, if it's not, I suppose the next operation isn't
-//                technically multiplication)
-// Return: whether the next operation is multiplication
-bool isNextOperatorMultiplication(ListIterator iter)
-{
-    bool isMultiplication;
-    iter.advance();
+        iter.advance();
+        int nextValue = factorValue(iter);
 
-    switch (iter.tokenChar())
-    {
-    case '*':
-    case '/':
-    case '%':
-        isMultiplication = true;
-        break;
-    default:
-        isMultiplication = false;
-        break;
+        if (operation == '*')
+        {
+            value *= nextValue;
+        }
+        else if (operation == '/')
+        {
+            value /= nextValue;
+        }
+        else
+        {
+            value %= nextValue;
+        }
     }
 
-    return isMultiplication;
+    return value;
 }
 
-// getValue
-// Gets the value of the number/expression at the current position
-// If the current value is an integer, return it
-// If it's a parenthetical expression, evaluate, and return
-// evalMultiplication is a flag used to ensure multiplication happens before addition
-// If true, it will handle any multiplication that is applied to the current value
-// That way, what is returned to the addition function is what we actually want to add
+// factorValue
+// Evaluates a factor: a number, a parenthesized sum, or the negative of a factor
 // Parameters:
 //     iter  - the iterator for the list of tokens
-//     evalMultiplication (input boolean) whether to evaluate multiplication, see above
-// Pre-condition:  expr[pos] is an int or parenthesis
-// Post-condition: expr[pos] is the end of the value
-//                 If it was an int, it's on the int
-//                 If it was a parenthesis, it's on the end parenthesis
-//                 If handling multiplication, it's on the last multiplied int
-// Return: value of int/expression
-int getValue(ListIterator& iter, bool evalMultiplication)
+// Pre-condition:  iter is on the first token of the factor
+// Post-condition: iter is on the first token after it
+//                 (after the closing parenthesis, for a parenthesized sum)
+// Return: value of the factor
+int factorValue(ListIterator& iter)
 {
     int value;
-    bool negative = false;
 
     if (iter.tokenChar() == '-')
     {
-        negative = true;
         iter.advance();
+        value = -factorValue(iter);
     }
-
-    if (iter.currentIsInteger())
+    else if (iter.currentIsInteger())
     {
-        value = (negative ? -1 : 1) * iter.integerValue();
-
-        while (evalMultiplication && isNextOperatorMultiplication(iter))
-        {
-            iter.advance();
-            handleMultiplyLevelOperation(iter, value);
-        }
+        value = iter.integerValue();
+        iter.advance();
     }
     else
     {
-        value = handleParenthesis(iter);
+        iter.advance();         // go past the (
+        value = sumValue(iter);
+        iter.advance();         // go past the )
     }
 
     return value;
@@ -0,0 +1,177 @@
+// Postfix Expression Implementation file
+// Converts an infix expression to postfix with the shunting-yard
+// algorithm, and evaluates the result with an array as its stack.
+//
+// The expressions may consist of the following:
+// -- integer values (which may have multiple digits)
+// -- simple arithmetic operators ( +, -, *, /, % )
+// -- negation, as a minus sign before any operand
+// -- matched parentheses for grouping
+
+#include <ctype.h>
+#include "postfix.h"
+
+// precedence
+// How tightly an operator binds its operands
+// Parameters:
+//     oper (input char) the operator, or '(' for a waiting parenthesis
+// Return: a larger number for a tighter binding; '(' is lowest of all,
+//         so that no operator is ever popped past it
+static int precedence(char oper)
+{
+    switch (oper)
+    {
+    case '~':
+        return 3;
+    case '*':
+    case '/':
+    case '%':
+        return 2;
+    case '+':
+    case '-':
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// PostfixExpr constructor
+// Converts an infix expression to postfix
+// Parameters:
+//     expr (input string) the expression to convert
+// Pre-condition: The expression is correctly formatted
+PostfixExpr::PostfixExpr(const char expr[])
+{
+    vector<char> waiting;           //Operators not yet output
+    bool expectOperand = true;      //Whether a '-' here is negation
+    int depth = 0,                  //Operands there will be on the stack
+        deepest = 0;                //  and the most there will ever be
+
+    for (const char *pos = expr; *pos != '\0'; ++pos)
+    {
+        char c = *pos;
+        if (c == ' ')
+            continue;
+
+        if (isdigit(c))
+        {
+            PostfixItem number = { 0, 0 };
+            while (isdigit(pos[1]))
+                number.value = number.value * 10 + (*pos++ - '0');
+            number.value = number.value * 10 + (*pos - '0');
+            items.push_back(number);
+
+            if (++depth > deepest)
+                deepest = depth;
+            expectOperand = false;
+        }
+        else if (c == '(')
+        {
+            waiting.push_back(c);
+            expectOperand = true;
+        }
+        else if (c == ')')
+        {
+            while (waiting.back() != '(')
+            {
+                PostfixItem oper = { waiting.back(), 0 };
+                items.push_back(oper);
+                waiting.pop_back();
+                if (oper.oper != '~')
+                    --depth;
+            }
+            waiting.pop_back();
+            expectOperand = false;
+        }
+        else if (expectOperand)
+        {
+            //Negation has no left operand, so nothing waiting can be
+            //finished yet -- it simply waits for its own operand
+            waiting.push_back('~');
+        }
+        else
+        {
+            //Every waiting operator that binds at least as tightly is
+            //complete (which makes the binary operators left-associative)
+            while (!waiting.empty() && precedence(waiting.back()) >= precedence(c))
+            {
+                PostfixItem oper = { waiting.back(), 0 };
+                items.push_back(oper);
+                waiting.pop_back();
+                if (oper.oper != '~')
+                    --depth;
+            }
+            waiting.push_back(c);
+            expectOperand = true;
+        }
+    }
+
+    while (!waiting.empty())
+    {
+        PostfixItem oper = { waiting.back(), 0 };
+        items.push_back(oper);
+        waiting.pop_back();
+    }
+
+    operands.resize(deepest > 0 ? deepest : 1);
+}
+
+// value
+// Evaluates the converted expression
+// This may be called any number of times; nothing is allocated.
+// Return: Value of the expression
+int PostfixExpr::value()
+{
+    int *top = &operands[0] - 1;    //Topmost operand, none to start
+
+    const PostfixItem *end = items.data() + items.size();
+    for (const PostfixItem *item = items.data(); item != end; ++item)
+    {
+        switch (item->oper)
+        {
+        case 0:
+            *++top = item->value;
+            break;
+        case '~':
+            *top = -*top;
+            break;
+        case '*':
+            top[-1] *= top[0];
+            --top;
+            break;
+        case '/':
+            top[-1] /= top[0];
+            --top;
+            break;
+        case '%':
+            top[-1] %= top[0];
+            --top;
+            break;
+        case '+':
+            top[-1] += top[0];
+            --top;
+            break;
+        case '-':
+            top[-1] -= top[0];
+            --top;
+            break;
+        }
+    }
+
+    //Value left on the top of the stack is the value of the expression
+    return operands[0];
+}
+
+//  output operation
+//  Display all of the items in postfix order
+ostream& operator<<( ostream &stream, const PostfixExpr &p )
+{
+    for (size_t i = 0; i < p.items.size(); ++i)
+    {
+	if (p.items[i].oper == 0)
+	    stream << p.items[i].value << " ";
+	else
+	    stream << p.items[i].oper << " ";
+    }
+    return stream;
+}
@@ -0,0 +1,44 @@
+#ifndef POSTFIX_H
+#define POSTFIX_H
+// Postfix Expression Header file
+// An expression converted once to postfix, which may then be
+// evaluated as many times as desired.
+//
+// The conversion is the shunting-yard algorithm: operands go straight
+// to the output, and operators wait on a stack until an operator of
+// no higher precedence (or a closing parenthesis) comes along.  Both
+// that stack and the output are arrays rather than linked lists, so
+// nothing is allocated per token, and the operand stack used for
+// evaluation is sized once, at conversion time, to the deepest it
+// will ever need to be.
+//
+// A minus sign where an operand is expected is negation, which is
+// displayed (and stored) as '~'.
+//
+// Nothing here writes to cout; to see the postfix form, display
+// the object with << .
+
+#include <iostream>
+#include <vector>
+using namespace std;
+
+// One element of a postfix expression
+struct PostfixItem
+{
+    char oper;          // the operator, or 0 for an integer
+    int  value;         // the value of an integer
+};
+
+class PostfixExpr
+{
+    friend ostream& operator<<( ostream &, const PostfixExpr & );
+    private:
+	vector<PostfixItem> items;	// the expression, in postfix order
+	vector<int> operands;		// evaluation stack, at its full depth
+    public:
+	PostfixExpr( const char[] );	// convert an infix expression
+
+	int value();			// evaluate the converted expression
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CHECKED_H
+#define CHECKED_H
+// Checked Arithmetic Header File
+// Compiling with -DCHECKED sends all arithmetic on values through
+// checkedArithmetic below, which notices a result too large for an
+// int, and division (or remainder) by zero -- where the plain
+// operators would have undefined behavior, or crash.  The caller
+// then reports the expression at fault and carries on with 0.
+//
+// Without -DCHECKED the plain operators are used as always, and
+// nothing here costs anything at all.
+
+#include <limits.h>
+#include <stddef.h>
+
+// checkedArithmetic
+// Applies one operator, noticing any result that is not defined
+// Parameters:
+//     oper   (input char)     one of + - * / % or ~ (negation of a)
+//     a, b   (input integers) the operands
+//     result (output integer) the result, if there is one
+// Returns:
+//     a description of what went wrong, or NULL if nothing did
+inline const char *checkedArithmetic( char oper, int a, int b, int &result )
+{
+    switch (oper)
+    {
+    case '+':
+        if (__builtin_add_overflow( a, b, &result ))
+            return "overflow";
+        return NULL;
+    case '-':
+        if (__builtin_sub_overflow( a, b, &result ))
+            return "overflow";
+        return NULL;
+    case '~':
+        if (__builtin_sub_overflow( 0, a, &result ))
+            return "overflow";
+        return NULL;
+    case '*':
+        if (__builtin_mul_overflow( a, b, &result ))
+            return "overflow";
+        return NULL;
+    case '/':
+    case '%':
+        if (b == 0)
+            return "division by zero";
+        if (b == -1 && a == INT_MIN)
+            return "overflow";
+        result = (oper == '/') ? a / b : a % b;
+        return NULL;
+    default:
+        return "unknown operator";
+    }
+}
+
+#endif
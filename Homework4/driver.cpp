@@ -1,6 +1,7 @@
 #include <iostream>
 using namespace std;
 #include "evaluate.h"
+#include "postfix.h"
 int main()
 {
     char userInput[80];
@@ -38,4 +39,7 @@ int main()
 
     cout << vars;*/
 
+#if defined(POSTFIX_STATS)
+    cout << "Postfix steps: " << postfixStats << endl;
+#endif
 }
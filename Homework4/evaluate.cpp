@@ -23,6 +23,7 @@
 #include <iostream>
 #include "tokenlist.h"
 #include "vartree.h"
+#include "postfix.h"
 
 using namespace std;
 
@@ -53,96 +54,15 @@ int evaluate(const char str[], VarTree &vars)
 
 // evaluatePostfix
 // Evaluates a postfix expression that operates on integers.
-// Parameter:
-//     postfix (input Token list) - expression to convert
+// To evaluate the same expression repeatedly, keep a PostfixProgram.
+// Parameters:
+//     postfix (input Token list) - expression to evaluate
+//     vars    (modified VarTree) - variables it refers to
 // Returns:    (integer) - value of the expression
 int evaluatePostfix(TokenList &t, VarTree& vars)
 {
-    TokenList values;
-    Token operand1, operand2;
-    int  value1, value2;
-    int  calc;
-
-    for (ListIterator curr = t.begin(); curr != t.end(); curr.advance())
-    {
-        if (!isOperator(curr.token())) // Must be a number or a variable if it's not an operator
-            values.push_front(curr.token());
-        else if (curr.token().tokenChar() == '~')
-        {
-            operand1 = values.pop_front();
-
-            // Grab operand1's value
-            if (operand1.isInteger())
-                value1 = operand1.integerValue();
-            else
-                value1 = vars.lookup(operand1.tokenText());
-
-            values.push_front(Token(-value1));
-        }
-        else if (curr.token().tokenChar() == '=')
-        {
-            operand2 = values.pop_front(); // The value being assigned
-            operand1 = values.pop_front(); // The variable to assign it to
-
-            // Grab operand2's value
-            if (operand2.isInteger())
-                value2 = operand2.integerValue();
-            else
-                value2 = vars.lookup(operand2.tokenText());
-
-            vars.assign(operand1.tokenText(), value2);
-
-            values.push_front(Token(value2)); // Push back on the result of the assignment
-        }
-        else
-        {
-            operand2 = values.pop_front();
-            operand1 = values.pop_front();
-
-            // Grab operand1's value
-            if (operand1.isInteger())
-                value1 = operand1.integerValue();
-            else
-                value1 = vars.lookup(operand1.tokenText());
-
-            // Grab operand2's value
-            if (operand2.isInteger())
-                value2 = operand2.integerValue();
-            else
-                value2 = vars.lookup(operand2.tokenText());
-
-            // Handle operation
-            switch (curr.token().tokenChar()) {
-                case '+': 
-                    calc = value1 + value2;
-                    break;
-                case '-': 
-                    calc = value1 - value2;
-                    break;
-                case '*':
-                    calc = value1 * value2;
-                    break;
-                case '/':
-                    calc = value1 / value2;
-                    break;
-                case '%': 
-                    calc = value1 % value2;
-                    break;
-                default: cout << "Operator " << curr.token().tokenChar() << " not recognized."; // This should never run since all non-operators are assumed to be variables!!!
-            }
-            values.push_front(Token(calc));
-        }
-    }
-
-    // In the case of the expression being just a variable, the last element left could be a variable, so we must account for this
-    operand1 = values.pop_front();
-
-    if (operand1.isInteger())
-        value1 = operand1.integerValue();
-    else
-        value1 = vars.lookup(operand1.tokenText());
-
-    return value1;
+    PostfixProgram program(t, vars);
+    return program.run();
 }
 
 // assignmentToPostfix
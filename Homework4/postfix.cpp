@@ -0,0 +1,221 @@
+// Postfix Program Implementation File
+// Prepares a postfix expression (as produced by evaluate.cpp) for
+// evaluation, and evaluates it.
+//
+// While a program is prepared, a constant or variable operand is not
+// loaded onto the stack right away.  It waits until the operator that
+// uses it, and is loaded just before that operator is applied; this
+// is what keeps a variable from being read before an assignment to it
+// that appears earlier.  If the operand waiting was the first of the
+// two, the operator is marked to find its operands in reverse order.
+
+#include <iostream>
+#include <sstream>
+using namespace std;
+
+#include "postfix.h"
+#include "tokenlist.h"
+#include "vartree.h"
+#include "checked.h"
+
+#if defined(POSTFIX_STATS)
+PostfixStats postfixStats;
+#endif
+
+// from evaluate.cpp
+bool isOperator(Token t);
+
+// makeStep
+// Helper to fill in a program step
+static PostfixStep makeStep(char oper, int value, int *slot)
+{
+    PostfixStep step;
+    step.oper = oper;
+    step.reversed = false;
+    step.value = value;
+    step.slot = slot;
+    return step;
+}
+
+// loadOperand
+// Loads an operand onto the stack, if it is not already there
+// Parameters:
+//     operand (input PostfixStep)     a load step, or 0 for a result
+//                                     already computed on the stack
+//     steps   (modified step vector)  program to add the load to
+//     depth   (modified integer)      values there will be on the stack
+//     deepest (modified integer)      most there have ever been
+// Returns:    (bool) - whether it needed loading
+static bool loadOperand(const PostfixStep &operand, vector<PostfixStep> &steps,
+        int &depth, int &deepest)
+{
+    if (operand.oper == 0)
+        return false;
+    steps.push_back(operand);
+    if (++depth > deepest)
+        deepest = depth;
+    return true;
+}
+
+// PostfixProgram constructor
+// Prepares a postfix expression for evaluation
+// Every variable it names is created in vars, if it is not there.
+// Parameters:
+//     postfix (input Token list)   expression to prepare
+//     vars    (modified VarTree)   variables it refers to
+// Pre-condition:  postfix is a valid postfix expression
+PostfixProgram::PostfixProgram( TokenList &postfix, VarTree &vars )
+{
+    vector<PostfixStep> operands;       // operands not yet used
+    const PostfixStep computed = makeStep(0, 0, NULL);
+    int depth = 0, deepest = 0;
+
+#if defined(CHECKED)
+    ostringstream display;
+    display << postfix;
+    text = display.str();
+#endif
+
+    for (ListIterator curr = postfix.begin(); curr != postfix.end(); curr.advance())
+    {
+        Token &t = curr.token();
+        if (t.isInteger())
+            operands.push_back(makeStep(LOAD_CONSTANT, t.integerValue(), NULL));
+        else if (!isOperator(t))
+            operands.push_back(makeStep(LOAD_VARIABLE, 0, vars.slot(t.tokenText())));
+        else if (t.tokenChar() == '~')
+        {
+            loadOperand(operands.back(), steps, depth, deepest);
+            steps.push_back(makeStep('~', 0, NULL));
+            operands.back() = computed;
+        }
+        else
+        {
+            PostfixStep right = operands.back();
+            operands.pop_back();
+            PostfixStep left = operands.back();
+
+            if (t.tokenChar() == '=' && left.oper == LOAD_VARIABLE)
+            {
+                loadOperand(right, steps, depth, deepest);
+                steps.push_back(makeStep('=', 0, left.slot));
+            }
+            else
+            {
+                // (which includes an assignment to something other than
+                // a variable -- not valid -- that just keeps the value)
+                PostfixStep oper = makeStep(t.tokenChar(), 0, NULL);
+                if (right.oper == 0)
+                    oper.reversed = loadOperand(left, steps, depth, deepest);
+                else
+                {
+                    loadOperand(left, steps, depth, deepest);
+                    loadOperand(right, steps, depth, deepest);
+                }
+                steps.push_back(oper);
+                --depth;
+            }
+            operands.back() = computed;
+        }
+    }
+
+    if (!operands.empty())
+        loadOperand(operands.back(), steps, depth, deepest);
+    stack.assign(deepest > 0 ? deepest : 1, 0);
+}
+
+// run
+// Evaluates the prepared expression
+// This may be done any number of times, and allocates nothing.
+// Returns:    (integer) - value of the expression
+int PostfixProgram::run()
+{
+    int *top = stack.data();            // just above the topmost value
+    POSTFIX_COUNT( runs );
+
+    const PostfixStep *end = steps.data() + steps.size();
+    for (const PostfixStep *step = steps.data(); step != end; ++step)
+    {
+        switch (step->oper)
+        {
+        case LOAD_CONSTANT:
+            POSTFIX_COUNT( constants );
+            *top++ = step->value;
+            break;
+        case LOAD_VARIABLE:
+            POSTFIX_COUNT( variables );
+            *top++ = *step->slot;
+            break;
+        case '~':
+            POSTFIX_COUNT( arithmetic );
+#if defined(CHECKED)
+            if (checkedArithmetic('~', top[-1], 0, top[-1]) != NULL)
+            {
+                cout << "Error: overflow in " << text << endl;
+                top[-1] = 0;
+            }
+#else
+            top[-1] = -top[-1];
+#endif
+            break;
+        case '=':
+            if (step->slot != NULL)
+            {
+                POSTFIX_COUNT( assignments );
+                *step->slot = top[-1];
+                break;
+            }
+            // else falls through -- not a valid assignment (see above)
+        default:
+        {
+            int value1 = top[-2], value2 = top[-1];
+            if (step->reversed)
+                swap(value1, value2);
+            int calc = value2;
+            --top;
+
+            POSTFIX_COUNT( arithmetic );
+#if defined(CHECKED)
+            const char *problem = step->oper == '=' ? NULL
+                    : checkedArithmetic(step->oper, value1, value2, calc);
+            if (problem != NULL)
+            {
+                cout << "Error: " << problem << " in " << text << endl;
+                calc = 0;
+            }
+#else
+            switch (step->oper)
+            {
+            case '+':
+                calc = value1 + value2;
+                break;
+            case '-':
+                calc = value1 - value2;
+                break;
+            case '*':
+                calc = value1 * value2;
+                break;
+            case '/':
+                calc = value1 / value2;
+                break;
+            case '%':
+                calc = value1 % value2;
+                break;
+            }
+#endif
+            top[-1] = calc;
+        }
+        }
+    }
+
+    return stack[0];
+}
+
+#if defined(POSTFIX_STATS)
+ostream& operator<<( ostream &stream, const PostfixStats &s )
+{
+    return stream << "runs=" << s.runs << " constants=" << s.constants
+                  << " variables=" << s.variables << " arithmetic=" << s.arithmetic
+                  << " assignments=" << s.assignments;
+}
+#endif
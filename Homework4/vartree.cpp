@@ -53,6 +53,19 @@ int VarTree::lookup( string name )
     return node->value;
 }
 
+//  slot
+//  Finds where a variable's value is kept, so that it may be used
+//  again and again without searching.  That place never changes.
+//  If the variable does not yet exist, it is created with value 0.
+//  Parameters:
+//      name (input string) name of variable
+//  Returns:  pointer to the value of the variable
+int* VarTree::slot( string name )
+{
+    TreeNode *node = recursiveSearch( root, name );
+    return &node->value;
+}
+
 //  assign
 //  Assigns a value to a variable.
 //  If the variable does not yet exist, it is created.
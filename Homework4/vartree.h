@@ -42,6 +42,7 @@ class VarTree
     }
     void assign( string, int );
     int lookup( string );
+    int* slot( string );
 
     private:        // these just help VarTree do its job
     TreeNode* recursiveSearch( TreeNode *&, string );
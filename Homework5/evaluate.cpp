@@ -26,12 +26,12 @@
 
 using namespace std;
 
-ExprNode* conditionalToTree(ListIterator& infix, TokenList& list);
-ExprNode* testToTree       (ListIterator& infix, TokenList& list);
-ExprNode* assignmentToTree (ListIterator& infix, TokenList& list);
-ExprNode* sumToTree        (ListIterator& infix, TokenList& list);
-ExprNode* prodToTree       (ListIterator& infix, TokenList& list);
-ExprNode* factorToTree     (ListIterator& infix, TokenList& list);
+ExprNode* conditionalToTree(ListIterator& infix, TokenList& list, NodeArena& arena);
+ExprNode* testToTree       (ListIterator& infix, TokenList& list, NodeArena& arena);
+ExprNode* assignmentToTree (ListIterator& infix, TokenList& list, NodeArena& arena);
+ExprNode* sumToTree        (ListIterator& infix, TokenList& list, NodeArena& arena);
+ExprNode* prodToTree       (ListIterator& infix, TokenList& list, NodeArena& arena);
+ExprNode* factorToTree     (ListIterator& infix, TokenList& list, NodeArena& arena);
 bool isOperator(Token t);
 string tokenText(ListIterator& infix, TokenList& list);
 
@@ -42,14 +42,18 @@ string tokenText(ListIterator& infix, TokenList& list);
 // Pre-condition:  str must be a valid integer arithmetic expression including matching parentheses.
 int evaluate(const char str[], VarTree &vars)
 {
+    static NodeArena lineArena;     // holds each tree until it is evaluated
+
     TokenList list(str);
     ListIterator iter = list.begin();
-    ExprNode* root = assignmentToTree(iter,list);
+    ExprNode* root = assignmentToTree(iter,list,lineArena);
 
     //cout << root->makedc() << endl
     //cout << *root << endl;
 
-    return root->evaluate(vars);
+    int result = root->evaluate(vars);
+    lineArena.release();
+    return result;
 }
 
 // assignmentToTree
@@ -58,7 +62,7 @@ int evaluate(const char str[], VarTree &vars)
 //     infix    (input Token list iterator)  - expression to convert
 // Returns:
 //     root node of the tree representing the assignment
-ExprNode* assignmentToTree(ListIterator& infix, TokenList& list)
+ExprNode* assignmentToTree(ListIterator& infix, TokenList& list, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -68,19 +72,19 @@ ExprNode* assignmentToTree(ListIterator& infix, TokenList& list)
     if (infix.tokenChar() == '-')    // if negative - This would count as improper formatting but I'll leave this in for the sake of keeping it from crashing
     {
         infix.advance();
-        Operation* negation = new Operation(conditionalToTree(infix,list),"~",NULL);
+        Operation* negation = new (arena) Operation(conditionalToTree(infix,list,arena),"~",NULL);
         lhs = static_cast<ExprNode *>(negation);
     }
     else
-        lhs = conditionalToTree(infix,list);
+        lhs = conditionalToTree(infix,list,arena);
 
     oper = tokenText(infix,list);
     while (oper == "=")
     {
         infix.advance();
 
-        rhs = assignmentToTree(infix,list); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = assignmentToTree(infix,list,arena); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //Doesn't actually apply here, but for consistency with other functions
 
         oper = tokenText(infix,list);
@@ -98,7 +102,7 @@ ExprNode* assignmentToTree(ListIterator& infix, TokenList& list)
 //     infix    (input Token list iterator)  - expression to convert
 // Returns:
 //     root node of the tree representing the conditional
-ExprNode* conditionalToTree(ListIterator &infix, TokenList& list)
+ExprNode* conditionalToTree(ListIterator &infix, TokenList& list, NodeArena& arena)
 {
     ExprNode* test      = NULL,
             * truecase  = NULL,
@@ -109,22 +113,22 @@ ExprNode* conditionalToTree(ListIterator &infix, TokenList& list)
     if (infix.tokenChar() == '-') //Would be improper for this to be true, but I'll leave it for stability
     {
         infix.advance();
-        Operation* negation = new Operation(testToTree(infix,list),"~",NULL);
+        Operation* negation = new (arena) Operation(testToTree(infix,list,arena),"~",NULL);
         test = static_cast<ExprNode *>(negation);
     }
     else
-        test = testToTree(infix,list);
+        test = testToTree(infix,list,arena);
 
     oper = tokenText(infix,list);
     while (oper == "?")
     {
         infix.advance();
-        truecase = testToTree(infix,list);
+        truecase = testToTree(infix,list,arena);
 
         infix.advance(); //Move past assumed ":"
-        falsecase = testToTree(infix,list);
+        falsecase = testToTree(infix,list,arena);
 
-        root = static_cast<ExprNode *>(new Conditional(test, truecase, falsecase));
+        root = static_cast<ExprNode *>(new (arena) Conditional(test, truecase, falsecase));
         test = root; //return of a coditional could be test for another. i mean, there should be parentheses, but hey, supporting it isn't hard
 
         oper = tokenText(infix,list);
@@ -142,7 +146,7 @@ ExprNode* conditionalToTree(ListIterator &infix, TokenList& list)
 //     infix    (input Token list iterator)  - expression to convert
 // Returns:
 //     root node of the tree representing the test
-ExprNode* testToTree(ListIterator &infix, TokenList& list)
+ExprNode* testToTree(ListIterator &infix, TokenList& list, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -152,19 +156,19 @@ ExprNode* testToTree(ListIterator &infix, TokenList& list)
     if (infix.tokenChar() == '-')
     {
         infix.advance();
-        Operation* negation = new Operation(sumToTree(infix,list),"~",NULL);
+        Operation* negation = new (arena) Operation(sumToTree(infix,list,arena),"~",NULL);
         lhs = static_cast<ExprNode *>(negation);
     }
     else
-        lhs = sumToTree(infix,list);
+        lhs = sumToTree(infix,list,arena);
 
     oper = tokenText(infix,list);
     while (oper == ">" || oper == "<" || oper == ">=" || oper == "<=" || oper == "==" || oper == "!=")
     {
         infix.advance();
 
-        rhs = sumToTree(infix,list); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = sumToTree(infix,list,arena); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //Doesn't actually apply here, but for consistency with other functions
 
         oper = tokenText(infix,list);
@@ -183,7 +187,7 @@ ExprNode* testToTree(ListIterator &infix, TokenList& list)
 //     infix  (input Token list iterator) - expression to convert
 // Returns:
 //     root node of the tree representing the sum
-ExprNode* sumToTree(ListIterator &infix, TokenList& list)
+ExprNode* sumToTree(ListIterator &infix, TokenList& list, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -193,19 +197,19 @@ ExprNode* sumToTree(ListIterator &infix, TokenList& list)
     if (infix.tokenChar() == '-')
     {
         infix.advance();
-        Operation* negation = new Operation(prodToTree(infix,list),"~",NULL);
+        Operation* negation = new (arena) Operation(prodToTree(infix,list,arena),"~",NULL);
         lhs = static_cast<ExprNode *>(negation);
     }
     else
-        lhs = prodToTree(infix,list);
+        lhs = prodToTree(infix,list,arena);
 
     oper = tokenText(infix,list);
     while (oper == "+" || oper == "-")
     {
         infix.advance();
 
-        rhs = prodToTree(infix,list);
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = prodToTree(infix,list,arena);
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //If we have multiple sums, the first sum becomes the left hand side of the first. This accounds for that.
 
         oper = tokenText(infix,list);
@@ -223,7 +227,7 @@ ExprNode* sumToTree(ListIterator &infix, TokenList& list)
 //     infix  (input Token list iterator) - expression to convert'
 // Returns:
 //     root node of the tree representing the sum
-ExprNode* prodToTree(ListIterator &infix, TokenList& list)
+ExprNode* prodToTree(ListIterator &infix, TokenList& list, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -231,15 +235,15 @@ ExprNode* prodToTree(ListIterator &infix, TokenList& list)
 
     string oper;
 
-    lhs = factorToTree(infix,list);
+    lhs = factorToTree(infix,list,arena);
 
     oper = tokenText(infix,list);
     while (oper == "*" || oper == "/" || oper == "%")
     {
         infix.advance();
 
-        rhs = factorToTree(infix,list);
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = factorToTree(infix,list,arena);
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //See this line in previous function for explaination of this line
 
         oper = tokenText(infix,list);
@@ -258,7 +262,7 @@ ExprNode* prodToTree(ListIterator &infix, TokenList& list)
 //     infix  (input Token List iterator) - expression to convert
 // Returns:
 //     root node of the tree representing the factor
-ExprNode* factorToTree(ListIterator &infix, TokenList& list)
+ExprNode* factorToTree(ListIterator &infix, TokenList& list, NodeArena& arena)
 {
     ExprNode* output = NULL;
 
@@ -268,23 +272,23 @@ ExprNode* factorToTree(ListIterator &infix, TokenList& list)
         {
             if (infix.currentIsInteger())
             {
-                output = static_cast<ExprNode *>(new Value(infix.integerValue()));
+                output = static_cast<ExprNode *>(new (arena) Value(infix.integerValue()));
             }
             else
             {
-                output = static_cast<ExprNode *>(new Variable(infix.token().tokenText()));
+                output = static_cast<ExprNode *>(new (arena) Variable(infix.token().tokenText()));
             }
             infix.advance();
         }
         else if (infix.tokenChar() == '-')
         {
             infix.advance();
-            output = static_cast<ExprNode *>(new Operation(factorToTree(infix,list),"~",NULL));
+            output = static_cast<ExprNode *>(new (arena) Operation(factorToTree(infix,list,arena),"~",NULL));
         }
         else
         {
             infix.advance();        // go past assumed (
-            output = assignmentToTree(infix,list);
+            output = assignmentToTree(infix,list,arena);
             infix.advance();        // go past assumed )
         }
     }
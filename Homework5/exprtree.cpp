@@ -9,6 +9,7 @@
 using namespace std;
 #include "exprtree.h"
 #include "tokenlist.h"
+#include "checked.h"
 
 // Outputting any tree node will simply output its string version
 ostream& operator<<( ostream &stream, const ExprNode &e )
@@ -16,6 +17,7 @@ ostream& operator<<( ostream &stream, const ExprNode &e )
     return stream << e.toString();
 }
 
+
 // A Value is just an integer value -- easy to evaluate
 // Unfortunately, the string class does not have a constructor for it
 string Value::toString() const
@@ -69,11 +71,39 @@ string Operation::toString() const
     return output.str();
 }
 
+// arithmetic
+// Evaluates the operands, left first, and applies an arithmetic
+// operator to them.  When compiled with -DCHECKED, a result that is
+// not defined is reported along with this expression, and taken to be 0.
+inline int Operation::arithmetic( char op, VarTree &v ) const
+{
+    int a = left->evaluate(v);
+    int b = (right != NULL) ? right->evaluate(v) : 0;
+#if defined(CHECKED)
+    int result;
+    const char *problem = checkedArithmetic( op, a, b, result );
+    if (problem == NULL)
+        return result;
+    cout << "Error: " << problem << " in " << *this << endl;
+    return 0;
+#else
+    switch (op)
+    {
+    case '+':   return a + b;
+    case '-':   return a - b;
+    case '*':   return a * b;
+    case '/':   return a / b;
+    case '~':   return -a;
+    default:    return a % b;
+    }
+#endif
+}
+
 int Operation::evaluate(VarTree& v) const
 {
     if (oper == "~") {
 
-        return -left->evaluate(v); //Right value will be NULL, as is handled when adding these values
+        return arithmetic('~', v); //Right value will be NULL, as is handled when adding these values
 
     } else if (oper == "=") {
         int value = right->evaluate(v);
@@ -84,23 +114,23 @@ int Operation::evaluate(VarTree& v) const
 
     } else if (oper == "+") {
 
-        return left->evaluate(v) + right->evaluate(v);
+        return arithmetic('+', v);
 
     } else if (oper == "-") {
 
-        return left->evaluate(v) - right->evaluate(v);
+        return arithmetic('-', v);
 
     } else if (oper == "*") {
 
-        return left->evaluate(v) * right->evaluate(v);
+        return arithmetic('*', v);
 
     } else if (oper == "/") {
 
-        return left->evaluate(v) / right->evaluate(v);
+        return arithmetic('/', v);
 
     } else if (oper == "%") {
 
-        return left->evaluate(v) % right->evaluate(v);
+        return arithmetic('%', v);
 
     } else if (oper == ">") {
 
@@ -4,17 +4,31 @@
 //  All objects in this structure are immutable --
 //  once constructed, they are never changed.
 //  They only be displayed or evaluated.
+//  Nodes are always allocated from a NodeArena (see arena.h),
+//  which destroys a whole tree at once.
 #include <iostream>
 using namespace std;
 #include "vartree.h"
+#include "arena.h"
 
 class ExprNode
 {
     public:
+    virtual ~ExprNode() {}
+    void* operator new( size_t size, NodeArena& arena )
+    {
+        return arena.allocate( size );
+    }
+    void operator delete( void* p, NodeArena& arena )	// only if a constructor throws
+    {
+        arena.discard( p );
+    }
     friend ostream& operator<<( ostream&, const ExprNode & );
     virtual string toString() const = 0;	// facilitates << operator
     virtual int evaluate( VarTree &v ) const = 0;  // evaluate this node
     virtual string makedc() const = 0;
+    protected:
+    void operator delete( void* ) {}	// nodes are only freed by their arena
 };
 
 class Value: public ExprNode
@@ -50,6 +64,7 @@ class Operation: public ExprNode
     private:
         string oper;
         ExprNode *left, *right;	 // operands
+        int arithmetic( char, VarTree &v ) const;
     public:
         string toString() const;	// facilitates << operator
         int evaluate( VarTree &v ) const;
@@ -0,0 +1,122 @@
+// Node Arena Implementation File
+// Each chunk is a header followed by the nodes themselves.  Every node
+// is preceded by a word recording its size, so that release() can
+// walk a chunk from front to back, destroying each node in turn.
+// Nodes hold only pointers, integers and strings, so word alignment
+// is all they need.
+
+#include <stdlib.h>
+#include <new>
+using namespace std;
+
+#include "arena.h"
+#include "exprtree.h"
+
+const size_t WORD = sizeof(size_t);
+const size_t UNBUILT = 1;       // marks a node whose constructor never finished
+
+struct NodeArena::Chunk
+{
+    Chunk *next;        // next chunk in the arena
+    size_t size;        // bytes of space after this header
+    size_t used;        // bytes handed out so far
+};
+
+NodeArena::NodeArena( size_t size )
+{
+    first = current = NULL;     // no chunks until the first node
+    chunkSize = size;
+    count = 0;
+}
+
+NodeArena::~NodeArena()
+{
+    release();
+    while (first != NULL)
+    {
+        Chunk *next = first->next;
+        free(first);
+        first = next;
+    }
+}
+
+//  newChunk
+//  Obtains a chunk from the heap
+//  Parameters:
+//      size    (input size_t)  bytes of space the chunk must hold
+//  Returns:    the new, empty chunk
+NodeArena::Chunk* NodeArena::newChunk( size_t size )
+{
+    if (size < chunkSize)
+        size = chunkSize;
+    Chunk *chunk = (Chunk *) malloc(sizeof(Chunk) + size);
+    if (chunk == NULL)
+        throw bad_alloc();
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+//  allocate
+//  Finds space for one node, after every node allocated before it
+//  Parameters:
+//      size    (input size_t)  size of the node
+//  Returns:    where the node should be constructed
+void *NodeArena::allocate( size_t size )
+{
+    size_t needed = WORD + (size + WORD - 1) / WORD * WORD;
+
+    if (current == NULL)
+        first = current = newChunk(needed);
+    while (current->used + needed > current->size)
+    {
+        //  move on to a chunk kept from an earlier tree, if it is
+        //  big enough, or else put a new one in after this one
+        if (current->next == NULL || current->next->size < needed)
+        {
+            Chunk *chunk = newChunk(needed);
+            chunk->next = current->next;
+            current->next = chunk;
+        }
+        current = current->next;
+    }
+
+    size_t *header = (size_t *) ((char *) (current + 1) + current->used);
+    *header = needed;
+    current->used += needed;
+    count++;
+    return header + 1;
+}
+
+//  discard
+//  Marks a node whose constructor failed, so release() will not destroy it
+//  Parameters:
+//      p       (input pointer) the space given out by allocate()
+void NodeArena::discard( void *p )
+{
+    size_t *header = (size_t *) p - 1;
+    *header |= UNBUILT;
+}
+
+//  release
+//  Destroys every node in the arena, and empties all the chunks
+//  so they may be filled again
+void NodeArena::release()
+{
+    for (Chunk *chunk = first; chunk != NULL; chunk = chunk->next)
+    {
+        char *place = (char *) (chunk + 1);
+        char *end = place + chunk->used;
+        while (place < end)
+        {
+            size_t header = *(size_t *) place;
+            if ((header & UNBUILT) == 0)
+                ((ExprNode *) (place + WORD))->~ExprNode();
+            place += header & ~UNBUILT;
+        }
+        chunk->used = 0;
+    }
+    current = first;
+    count = 0;
+}
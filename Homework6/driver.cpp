@@ -1,5 +1,8 @@
 #include <iostream>
 #include <string>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
 using namespace std;
 #include "evaluate.h"
 
@@ -9,21 +12,63 @@ using namespace std;
 #define endfunction() cout << endl;
 #endif
 
-int main()
+//  A prompt or a result need be flushed at once only when someone is
+//  watching; otherwise the output is left to collect in its buffer
+static bool interactive = isatty( STDOUT_FILENO );
+
+static void prompt( const char *text )
+{
+    cout << text;
+    if (interactive)
+        cout.flush();
+}
+
+int main( int argc, char *argv[] )
 {
     //char userInput[80];
     VarTree vars;		// initially empty tree
     FunctionDef funs;
 
     string input;
-    cout << "Interactive? (y|N): ";
-    cout.flush();
+    if (!interactive)
+        cin.tie( NULL );        // nor need reading input flush cout
+    if (argc > 1 && strcmp(argv[1], "-r") == 0)
+    {
+        //  reactive mode: assignments are kept as formulas, like a spreadsheet
+        FormulaTable formulas;
+        cout << "Reactive mode.  Use an empty line to quit." << endl;
+        cout << "An assignment using other variables is recomputed when they change." << endl << endl;
+        do {
+            prompt( "> " );
+            getline(cin, input);
+            if (input != "")
+            {
+                int before = formulas.recomputeCount();
+                int result = evaluate(input.c_str(), vars, funs, formulas);
+                cout << result << "    (" << formulas.recomputeCount() - before
+                     << " recomputed)\n\n";
+            }
+        } while (input != "");
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "-c") == 0)
+    {
+        //  batch mode with a parse cache, holding up to the given number of trees
+        ParseCache cache(argc > 2 ? atoi(argv[2]) : 1000);
+        while (getline(cin, input) && input != "")
+            cout << evaluate(input.c_str(), vars, funs, cache) << '\n';
+        cout << "Parse cache: " << cache.hits() << " hits, " << cache.misses()
+             << " misses, " << cache.size() << " of " << cache.capacity() << " trees kept" << endl;
+        return 0;
+    }
+
+    prompt( "Interactive? (y|N): " );
 
     getline(cin, input);
     while (input != "y" && input != "Y" && input != "n" && input != "N" && input != "")
     {
-        cout << "Interactive? (y|N): ";
-        cout.flush();
+        prompt( "Interactive? (y|N): " );
         getline(cin, input);
     }
 
@@ -76,10 +121,9 @@ int main()
         cout << "Use an empty line to quit." << endl;
         cout << "A return of 0 on a function definition indicates success." << endl << endl;
         do {
-            cout << "> ";
-            cout.flush();
+            prompt( "> " );
             getline(cin, input);
-            if (input != "") cout << evaluate(input.c_str(), vars, funs) << endl << endl;
+            if (input != "") cout << evaluate(input.c_str(), vars, funs) << "\n\n";
         } while (input != "");
     }
 }
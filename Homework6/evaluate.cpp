@@ -24,17 +24,20 @@
 #include "tokenlist.h"
 #include "exprtree.h"
 #include "funmap.h"
+#include "formula.h"
+#include "parsecache.h"
 
 using namespace std;
 
-ExprNode* conditionalToTree(ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* testToTree       (ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* assignmentToTree (ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* sumToTree        (ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* prodToTree       (ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* factorToTree     (ListIterator& infix, TokenList& list, FunctionDef& funs);
+ExprNode* conditionalToTree(ListIterator& infix, TokenList& list, FunctionDef& funs, NodeArena& arena);
+ExprNode* testToTree       (ListIterator& infix, TokenList& list, FunctionDef& funs, NodeArena& arena);
+ExprNode* assignmentToTree (ListIterator& infix, TokenList& list, FunctionDef& funs, NodeArena& arena);
+ExprNode* sumToTree        (ListIterator& infix, TokenList& list, FunctionDef& funs, NodeArena& arena);
+ExprNode* prodToTree       (ListIterator& infix, TokenList& list, FunctionDef& funs, NodeArena& arena);
+ExprNode* factorToTree     (ListIterator& infix, TokenList& list, FunctionDef& funs, NodeArena& arena);
 void      makeFunction     (ListIterator& infix, TokenList& list, FunctionDef& funs);
 bool isOperator(Token t);
+bool isCall(ListIterator& infix, TokenList& list);
 string tokenText(ListIterator& infix, TokenList& list);
 
 // Evaluate
@@ -44,6 +47,8 @@ string tokenText(ListIterator& infix, TokenList& list);
 // Pre-condition:  str must be a valid integer arithmetic expression including matching parentheses.
 int evaluate(const char str[], VarTree &vars, FunctionDef& funs)
 {
+    static NodeArena lineArena;     // holds each tree until it is evaluated
+
     TokenList list(str);
     ListIterator iter = list.begin();
 
@@ -55,30 +60,83 @@ int evaluate(const char str[], VarTree &vars, FunctionDef& funs)
     }
     else
     {
-        ExprNode* root = assignmentToTree(iter,list,funs);
+        ExprNode* root = assignmentToTree(iter,list,funs,lineArena);
 #ifdef DEBUG
         cout << *root << endl;
 #endif
-        return root->evaluate(vars, funs);
+        int result = root->evaluate(vars, funs);
+        lineArena.release();
+        return result;
     }
 
     //cout << root->makedc() << endl
     //cout << *root << endl;
 }
 
+// Evaluate, in reactive mode
+// Each line is parsed into an arena of its own, so that the tree
+// can be kept if the formula table wants it.
+// Parameters:
+//     str      (input char array)       string to evaluate
+//     formulas (modified FormulaTable)  formulas to keep up to date
+int evaluate(const char str[], VarTree &vars, FunctionDef& funs, FormulaTable& formulas)
+{
+    TokenList list(str);
+    ListIterator iter = list.begin();
+
+    if (tokenText(iter,list) == "deffn")
+    {
+        makeFunction(iter, list, funs);
+        formulas.invalidate();      // a formula may call this function
+        return 0;
+    }
+
+    NodeArena* arena = new NodeArena(1024);
+    ExprNode* root = assignmentToTree(iter,list,funs,*arena);
+#ifdef DEBUG
+    cout << *root << endl;
+#endif
+    return formulas.evaluate(root, arena, vars, funs);
+}
+
+// Evaluate, with a parse cache
+// A text found in the cache is evaluated without tokenizing or
+// parsing it at all.  Function definitions are never cached,
+// and with no capacity at all, nothing is.
+// Parameters:
+//     str      (input char array)      string to evaluate
+//     cache    (modified ParseCache)   trees parsed so far
+int evaluate(const char str[], VarTree &vars, FunctionDef& funs, ParseCache& cache)
+{
+    string key = ParseCache::normalize(str);
+    if (key.compare(0, 6, "deffn ") == 0 || cache.capacity() == 0)
+        return evaluate(str, vars, funs);
+
+    ExprNode* root = cache.lookup(key);
+    if (root == NULL)
+    {
+        TokenList list(str);
+        ListIterator iter = list.begin();
+        NodeArena* arena = new NodeArena(1024);
+        root = assignmentToTree(iter,list,funs,*arena);
+        cache.insert(key, root, arena);
+    }
+#ifdef DEBUG
+    cout << *root << endl;
+#endif
+    return root->evaluate(vars, funs);
+}
+
 void makeFunction(ListIterator& infix, TokenList& list, FunctionDef& funs)
 {
     infix.advance(); //advance past deffn
 
     string name = tokenText(infix, list);
-    funs[name] = FunDef();
-
-    FunDef* function = &funs[name]; //to avoid multiple lookups in this function body
-
-    function->name = name;
+    FunDef* function = bindFunction(funs, name); //the same FunDef any earlier calls refer to
     infix.advance(); //advance past function name
     infix.advance(); //advance past '('
 
+    delete function->locals;        // any earlier definition is replaced
     function->locals = new VarTree();
 
     int paramcount = 0;
@@ -99,7 +157,9 @@ void makeFunction(ListIterator& infix, TokenList& list, FunctionDef& funs)
     for (int i = paramcount; i < 10; ++i)
         function->parameter[i] = "";
 
-    function->functionBody = assignmentToTree(infix,list,funs);
+    delete function->nodes;         // along with its body
+    function->nodes = new NodeArena(1024);
+    function->functionBody = assignmentToTree(infix,list,funs,*function->nodes);
 
 #ifdef DEBUG
     cout << "Function:" << endl;
@@ -119,7 +179,7 @@ void makeFunction(ListIterator& infix, TokenList& list, FunctionDef& funs)
 //     infix    (input Token list iterator)  - expression to convert
 // Returns:
 //     root node of the tree representing the assignment
-ExprNode* assignmentToTree(ListIterator& infix, TokenList& list, FunctionDef& funs)
+ExprNode* assignmentToTree(ListIterator& infix, TokenList& list, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -129,19 +189,19 @@ ExprNode* assignmentToTree(ListIterator& infix, TokenList& list, FunctionDef& fu
     if (infix.tokenChar() == '-')    // if negative - This would count as improper formatting but I'll leave this in for the sake of keeping it from crashing
     {
         infix.advance();
-        Operation* negation = new Operation(conditionalToTree(infix,list,funs),"*",new Value(-1));
+        Operation* negation = new (arena) Operation(conditionalToTree(infix,list,funs,arena),"*",new (arena) Value(-1));
         lhs = static_cast<ExprNode *>(negation);
     }
     else
-        lhs = conditionalToTree(infix,list,funs);
+        lhs = conditionalToTree(infix,list,funs,arena);
 
     oper = tokenText(infix,list);
     while (oper == "=")
     {
         infix.advance();
 
-        rhs = assignmentToTree(infix,list,funs); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = assignmentToTree(infix,list,funs,arena); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //Doesn't actually apply here, but for consistency with other functions
 
         oper = tokenText(infix,list);
@@ -159,7 +219,7 @@ ExprNode* assignmentToTree(ListIterator& infix, TokenList& list, FunctionDef& fu
 //     infix    (input Token list iterator)  - expression to convert
 // Returns:
 //     root node of the tree representing the conditional
-ExprNode* conditionalToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* conditionalToTree(ListIterator &infix, TokenList& list, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* test      = NULL,
             * truecase  = NULL,
@@ -170,22 +230,22 @@ ExprNode* conditionalToTree(ListIterator &infix, TokenList& list, FunctionDef& f
     if (infix.tokenChar() == '-') //Would be improper for this to be true, but I'll leave it for stability
     {
         infix.advance();
-        Operation* negation = new Operation(testToTree(infix,list,funs),"*",new Value(-1));
+        Operation* negation = new (arena) Operation(testToTree(infix,list,funs,arena),"*",new (arena) Value(-1));
         test = static_cast<ExprNode *>(negation);
     }
     else
-        test = testToTree(infix,list,funs);
+        test = testToTree(infix,list,funs,arena);
 
     oper = tokenText(infix,list);
     while (oper == "?")
     {
         infix.advance();
-        truecase = testToTree(infix,list,funs);
+        truecase = testToTree(infix,list,funs,arena);
 
         infix.advance(); //Move past assumed ":"
-        falsecase = testToTree(infix,list,funs);
+        falsecase = testToTree(infix,list,funs,arena);
 
-        root = static_cast<ExprNode *>(new Conditional(test, truecase, falsecase));
+        root = static_cast<ExprNode *>(new (arena) Conditional(test, truecase, falsecase));
         test = root; //return of a coditional could be test for another. i mean, there should be parentheses, but hey, supporting it isn't hard
 
         oper = tokenText(infix,list);
@@ -203,7 +263,7 @@ ExprNode* conditionalToTree(ListIterator &infix, TokenList& list, FunctionDef& f
 //     infix    (input Token list iterator)  - expression to convert
 // Returns:
 //     root node of the tree representing the test
-ExprNode* testToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* testToTree(ListIterator &infix, TokenList& list, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -213,19 +273,19 @@ ExprNode* testToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
     if (infix.tokenChar() == '-')
     {
         infix.advance();
-        Operation* negation = new Operation(sumToTree(infix,list,funs),"*",new Value(-1));
+        Operation* negation = new (arena) Operation(sumToTree(infix,list,funs,arena),"*",new (arena) Value(-1));
         lhs = static_cast<ExprNode *>(negation);
     }
     else
-        lhs = sumToTree(infix,list,funs);
+        lhs = sumToTree(infix,list,funs,arena);
 
     oper = tokenText(infix,list);
     while (oper == ">" || oper == "<" || oper == ">=" || oper == "<=" || oper == "==" || oper == "!=")
     {
         infix.advance();
 
-        rhs = sumToTree(infix,list,funs); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = sumToTree(infix,list,funs,arena); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //Doesn't actually apply here, but for consistency with other functions
 
         oper = tokenText(infix,list);
@@ -244,7 +304,7 @@ ExprNode* testToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
 //     infix  (input Token list iterator) - expression to convert
 // Returns:
 //     root node of the tree representing the sum
-ExprNode* sumToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* sumToTree(ListIterator &infix, TokenList& list, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -254,19 +314,19 @@ ExprNode* sumToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
     if (infix.tokenChar() == '-')
     {
         infix.advance();
-        Operation* negation = new Operation(prodToTree(infix,list,funs),"*",new Value(-1));
+        Operation* negation = new (arena) Operation(prodToTree(infix,list,funs,arena),"*",new (arena) Value(-1));
         lhs = static_cast<ExprNode *>(negation);
     }
     else
-        lhs = prodToTree(infix,list,funs);
+        lhs = prodToTree(infix,list,funs,arena);
 
     oper = tokenText(infix,list);
     while (oper == "+" || oper == "-")
     {
         infix.advance();
 
-        rhs = prodToTree(infix,list,funs);
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = prodToTree(infix,list,funs,arena);
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //If we have multiple sums, the first sum becomes the left hand side of the first. This accounds for that.
 
         oper = tokenText(infix,list);
@@ -284,7 +344,7 @@ ExprNode* sumToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
 //     infix  (input Token list iterator) - expression to convert'
 // Returns:
 //     root node of the tree representing the sum
-ExprNode* prodToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* prodToTree(ListIterator &infix, TokenList& list, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -292,15 +352,15 @@ ExprNode* prodToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
 
     string oper;
 
-    lhs = factorToTree(infix,list,funs);
+    lhs = factorToTree(infix,list,funs,arena);
 
     oper = tokenText(infix,list);
     while (oper == "*" || oper == "/" || oper == "%")
     {
         infix.advance();
 
-        rhs = factorToTree(infix,list,funs);
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = factorToTree(infix,list,funs,arena);
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //See this line in previous function for explaination of this line
 
         oper = tokenText(infix,list);
@@ -319,7 +379,7 @@ ExprNode* prodToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
 //     infix  (input Token List iterator) - expression to convert
 // Returns:
 //     root node of the tree representing the factor
-ExprNode* factorToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* factorToTree(ListIterator &infix, TokenList& list, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* output = NULL;
 
@@ -329,11 +389,11 @@ ExprNode* factorToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
         {
             if (infix.currentIsInteger())
             {
-                output = static_cast<ExprNode *>(new Value(infix.integerValue()));
+                output = static_cast<ExprNode *>(new (arena) Value(infix.integerValue()));
             }
-            else if (funs.find(tokenText(infix, list)) != funs.end()) // function call
+            else if (isCall(infix, list)) // function call
             {
-                string name = tokenText(infix, list);
+                FunDef* function = bindFunction(funs, tokenText(infix, list));
                 infix.advance(); //now on '('
                 infix.advance(); //now past '('
 
@@ -342,7 +402,7 @@ ExprNode* factorToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
                 {
                     if (tokenText(infix, list) != ")")
                     {
-                        params[i] = assignmentToTree(infix, list, funs); //now on either ',' or ')'
+                        params[i] = assignmentToTree(infix, list, funs, arena); //now on either ',' or ')'
                         if (tokenText(infix, list) == ",")
                             infix.advance();
                         //now on either next param or ')'
@@ -351,23 +411,23 @@ ExprNode* factorToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
                         params[i] = NULL;
                 } //now on ')', which is handled by infix.advance() later
 
-                output = static_cast<ExprNode *>(new Function(name, params));
+                output = static_cast<ExprNode *>(new (arena) Function(function, params));
             }
             else
             {
-                output = static_cast<ExprNode *>(new Variable(infix.token().tokenText()));
+                output = static_cast<ExprNode *>(new (arena) Variable(infix.token().tokenText()));
             }
             infix.advance();
         }
         else if (infix.tokenChar() == '-')
         {
             infix.advance();
-            output = static_cast<ExprNode *>(new Operation(factorToTree(infix,list,funs),"*",new Value(-1)));
+            output = static_cast<ExprNode *>(new (arena) Operation(factorToTree(infix,list,funs,arena),"*",new (arena) Value(-1)));
         }
         else
         {
             infix.advance();        // go past assumed (
-            output = assignmentToTree(infix, list, funs);
+            output = assignmentToTree(infix, list, funs, arena);
             infix.advance();        // go past assumed )
         }
     }
@@ -376,6 +436,21 @@ ExprNode* factorToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
                    //expression......so....don't do that
 }
 
+// isCall
+// Tells whether a name is that of a function being called, which is
+// so if it is followed by a parenthesis.  The function need not be
+// defined yet; the call is bound to it all the same (see funmap.h).
+// Parameters:
+//     infix (input Token List iterator) - the name
+// Returns:
+//     (bool) - whether the name is followed by '('
+bool isCall(ListIterator& infix, TokenList& list)
+{
+    ListIterator next = infix;
+    next.advance();
+    return next != list.end() && next.tokenChar() == '(';
+}
+
 // isOperator
 // Tells whether the token is an operator.
 // This function knows all of the operators used in the postfix expression.
@@ -16,6 +16,8 @@
 
 #include "vartree.h"
 #include "funmap.h"
+#include "formula.h"
+#include "parsecache.h"
 
 // Evaluate
 // Evaluate the given expression, with the given variables defined
@@ -25,3 +27,24 @@
 //	vars	(modified VarTree)	variables to work with
 //	funs	(modified FunctionDef)	functions to define or call
 int evaluate( const char expr[], VarTree &vars, FunctionDef &funs );
+
+// Evaluate, in reactive mode
+// As above, except that assignments may be kept as formulas,
+// and recomputed only when the variables they use change
+// (see formula.h)
+// Parameters:
+//	expr	(input char array)	expression to evaluate
+//	vars	(modified VarTree)	variables to work with
+//	funs	(modified FunctionDef)	functions to define or call
+//	formulas (modified FormulaTable) formulas to keep up to date
+int evaluate( const char expr[], VarTree &vars, FunctionDef &funs, FormulaTable &formulas );
+
+// Evaluate, with a parse cache
+// As above, except that a text seen before is not parsed again,
+// but its tree is taken from the cache (see parsecache.h)
+// Parameters:
+//	expr	(input char array)	expression to evaluate
+//	vars	(modified VarTree)	variables to work with
+//	funs	(modified FunctionDef)	functions to define or call
+//	cache	(modified ParseCache)	trees parsed so far
+int evaluate( const char expr[], VarTree &vars, FunctionDef &funs, ParseCache &cache );
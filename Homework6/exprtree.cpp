@@ -9,6 +9,7 @@
 using namespace std;
 #include "exprtree.h"
 #include "tokenlist.h"
+#include "checked.h"
 
 // Outputting any tree node will simply output its string version
 ostream& operator<<( ostream &stream, const ExprNode &e )
@@ -16,6 +17,7 @@ ostream& operator<<( ostream &stream, const ExprNode &e )
     return stream << e.toString();
 }
 
+
 // A Value is just an integer value -- easy to evaluate
 // Unfortunately, the string class does not have a constructor for it
 string Value::toString() const
@@ -35,6 +37,15 @@ string Value::makedc() const
     return toString() + " ";
 }
 
+//  findVariables
+//  Collects the names of the variables an expression uses and assigns
+//  Parameters:
+//      used     (modified set)  variables whose values are read
+//      assigned (modified set)  variables that are assigned to
+void Value::findVariables( set<string>& used, set<string>& assigned ) const
+{
+}
+
 //  A variable is just an alphabetic string -- easy to display
 //  To evaluate, would need to look it up in the data structure
 string Variable::toString() const
@@ -54,6 +65,11 @@ string Variable::makedc() const
     return output.str();
 }
 
+void Variable::findVariables( set<string>& used, set<string>& assigned ) const
+{
+    used.insert( name );
+}
+
 
 string Operation::toString() const
 {
@@ -64,6 +80,33 @@ string Operation::toString() const
     return output.str();
 }
 
+// arithmetic
+// Evaluates the operands, left first, and applies an arithmetic
+// operator to them.  When compiled with -DCHECKED, a result that is
+// not defined is reported along with this expression, and taken to be 0.
+inline int Operation::arithmetic( char op, VarTree &v, FunctionDef &funs ) const
+{
+    int a = left->evaluate(v, funs);
+    int b = right->evaluate(v, funs);
+#if defined(CHECKED)
+    int result;
+    const char *problem = checkedArithmetic( op, a, b, result );
+    if (problem == NULL)
+        return result;
+    cout << "Error: " << problem << " in " << *this << endl;
+    return 0;
+#else
+    switch (op)
+    {
+    case '+':   return a + b;
+    case '-':   return a - b;
+    case '*':   return a * b;
+    case '/':   return a / b;
+    default:    return a % b;
+    }
+#endif
+}
+
 int Operation::evaluate(VarTree& v, FunctionDef& funs) const
 {
     if (oper == "=") {
@@ -75,23 +118,23 @@ int Operation::evaluate(VarTree& v, FunctionDef& funs) const
 
     } else if (oper == "+") {
 
-        return left->evaluate(v, funs) + right->evaluate(v, funs);
+        return arithmetic('+', v, funs);
 
     } else if (oper == "-") {
 
-        return left->evaluate(v, funs) - right->evaluate(v, funs);
+        return arithmetic('-', v, funs);
 
     } else if (oper == "*") {
 
-        return left->evaluate(v, funs) * right->evaluate(v, funs);
+        return arithmetic('*', v, funs);
 
     } else if (oper == "/") {
 
-        return left->evaluate(v, funs) / right->evaluate(v, funs);
+        return arithmetic('/', v, funs);
 
     } else if (oper == "%") {
 
-        return left->evaluate(v, funs) % right->evaluate(v, funs);
+        return arithmetic('%', v, funs);
 
     } else if (oper == ">") {
 
@@ -171,6 +214,16 @@ string Operation::makedc() const
     return output.str();
 }
 
+//  The target of an assignment is collected as assigned, not used
+void Operation::findVariables( set<string>& used, set<string>& assigned ) const
+{
+    if (oper == "=")
+        left->findVariables(assigned, assigned);
+    else
+        left->findVariables(used, assigned);
+    if (right != NULL)
+        right->findVariables(used, assigned);
+}
 
 string Conditional::toString() const
 {
@@ -187,11 +240,18 @@ string Conditional::makedc() const
     return " Conditional operator not supported. ";
 }
 
+void Conditional::findVariables( set<string>& used, set<string>& assigned ) const
+{
+    test->findVariables(used, assigned);
+    trueCase->findVariables(used, assigned);
+    falseCase->findVariables(used, assigned);
+}
+
 string Function::toString() const
 {
     stringstream output;
 
-    output << name;
+    output << function->name;
     output << "(";
 
     for (int i = 0; i < 10 && params[i] != NULL; ++i)
@@ -206,24 +266,33 @@ string Function::toString() const
     return output.str();
 }
 
+//  The call was bound to its function when it was parsed, but the
+//  function might not have been defined since
 int Function::evaluate(VarTree& v, FunctionDef& funs) const
 {
-    FunDef* function = &funs[name]; //using location to avoid unnecessary copying
-    VarTree* localtree = new VarTree(); //multiple recursive calls (like in the basic fibonacci function)
-                                        //cause issues with overwriting, so we make a new vartree for each 
-                                        //function call
+    if (function->functionBody == NULL)
+    {
+        cout << "Function \"" << function->name << "\" is not defined." << endl;
+        return 0;
+    }
+    VarTree localtree;  //multiple recursive calls (like in the basic fibonacci function)
+                        //cause issues with overwriting, so we make a new vartree for each 
+                        //function call, which deletes its variables when the call returns
     for (int i = 0; i < 10 && function->parameter[i] != ""; ++i)
-        localtree->assign(function->parameter[i], params[i]->evaluate(v, funs));
+        localtree.assign(function->parameter[i], params[i]->evaluate(v, funs));
 
-    int result = function->functionBody->evaluate(*localtree, funs);
-
-    delete localtree; //remove the localtree. technically, there's a memory leak here, as the destructor for
-                      //vartree does not delete the nodes, but there's nothing I can really do about that
-
-    return result;
+    return function->functionBody->evaluate(localtree, funs);
 }
 
 string Function::makedc() const
 {
     return " Functions not supported. ";
 }
+
+//  Only the arguments are searched -- the function body has
+//  variables of its own
+void Function::findVariables( set<string>& used, set<string>& assigned ) const
+{
+    for (int i = 0; i < 10 && params[i] != NULL; ++i)
+        params[i]->findVariables(used, assigned);
+}
@@ -4,18 +4,34 @@
 //  All objects in this structure are immutable --
 //  once constructed, they are never changed.
 //  They only be displayed or evaluated.
+//  Nodes are always allocated from a NodeArena (see arena.h),
+//  which destroys a whole tree at once.
 #include <iostream>
+#include <set>
 using namespace std;
 #include "vartree.h"
+#include "arena.h"
 #include "funmap.h"
 
 class ExprNode
 {
     public:
+    virtual ~ExprNode() {}
+    void* operator new( size_t size, NodeArena& arena )
+    {
+        return arena.allocate( size );
+    }
+    void operator delete( void* p, NodeArena& arena )	// only if a constructor throws
+    {
+        arena.discard( p );
+    }
     friend ostream& operator<<( ostream&, const ExprNode & );
     virtual string toString() const = 0;	// facilitates << operator
     virtual int evaluate( VarTree &v, FunctionDef& funs ) const = 0;  // evaluate this node
     virtual string makedc() const = 0;
+    virtual void findVariables( set<string>& used, set<string>& assigned ) const = 0;
+    protected:
+    void operator delete( void* ) {}	// nodes are only freed by their arena
 };
 
 class Value: public ExprNode
@@ -30,6 +46,7 @@ class Value: public ExprNode
             value = v;
         }
         string makedc() const;
+        void findVariables( set<string>& used, set<string>& assigned ) const;
 };
 
 class Variable: public ExprNode
@@ -44,6 +61,7 @@ class Variable: public ExprNode
             name = var;
         }
         string makedc() const;
+        void findVariables( set<string>& used, set<string>& assigned ) const;
 };
 
 class Operation: public ExprNode
@@ -51,6 +69,7 @@ class Operation: public ExprNode
     private:
         string oper;
         ExprNode *left, *right;	 // operands
+        int arithmetic( char, VarTree &v, FunctionDef &funs ) const;
     public:
         string toString() const;	// facilitates << operator
         int evaluate( VarTree &v, FunctionDef& funs ) const;
@@ -60,7 +79,11 @@ class Operation: public ExprNode
             right = r;
             oper = o;
         }
+        string operation() const { return oper; }
+        ExprNode* leftOperand() const { return left; }
+        ExprNode* rightOperand() const { return right; }
         string makedc() const;
+        void findVariables( set<string>& used, set<string>& assigned ) const;
 };
 
 class Conditional: public ExprNode
@@ -77,21 +100,23 @@ class Conditional: public ExprNode
             falseCase = f;
         }
         string makedc() const;
+        void findVariables( set<string>& used, set<string>& assigned ) const;
 };
 
 class Function : public ExprNode
 {
     private:
-        string name;
+        FunDef* function;	// bound when the call is parsed
         ExprNode* params[10];
     public:
         string toString() const;
         int evaluate(VarTree& v, FunctionDef& funs) const;
-        Function(string _name, ExprNode* _params[10])
+        Function(FunDef* _function, ExprNode* _params[10])
         {
-            name = _name;
+            function = _function;
             for (int i = 0; i < 10; ++i)
                 params[i] = _params[i];
         }
         string makedc() const;
+        void findVariables( set<string>& used, set<string>& assigned ) const;
 };
@@ -0,0 +1,142 @@
+// Formula Table Implementation File
+// The table keeps two maps: the formula for each variable that has one,
+// and, going the other way, the formulas that use each variable.
+// A change to a variable follows the second map to mark everything
+// downstream of it dirty; reading a variable follows the first map
+// to recompute it, and whatever it depends on, only as needed.
+
+#include <iostream>
+using namespace std;
+
+#include "formula.h"
+#include "exprtree.h"
+
+FormulaTable::~FormulaTable()
+{
+    for (map<string, Formula>::iterator f = formulas.begin(); f != formulas.end(); ++f)
+        delete f->second.arena;
+}
+
+//  evaluate
+//  Evaluates a parsed line, first bringing up to date any formula it
+//  reads.  If the line is an assignment that qualifies as a formula,
+//  the table keeps the tree, and takes over its arena; otherwise the
+//  arena is deleted here.
+//  Parameters:
+//      root    (input ExprNode ptr)    the parsed line
+//      arena   (input NodeArena ptr)   arena holding that tree alone
+//      vars    (modified VarTree)      variables to work with
+//      funs    (input FunctionDef)     functions that may be called
+//  Returns:    the value of the line
+int FormulaTable::evaluate( ExprNode *root, NodeArena *arena, VarTree &vars, FunctionDef &funs )
+{
+    set<string> used, assigned;
+    root->findVariables(used, assigned);
+    for (set<string>::iterator u = used.begin(); u != used.end(); ++u)
+        refresh(*u, vars, funs);
+
+    Operation *assignment = dynamic_cast<Operation *>(root);
+    if (assignment != NULL && assignment->operation() == "=")
+    {
+        string target = assignment->leftOperand()->toString();
+        const ExprNode *value = assignment->rightOperand();
+        set<string> inputs, writes;
+        value->findVariables(inputs, writes);
+
+        if (writes.empty() && !inputs.empty() && inputs.count(target) == 0)
+        {
+            forget(target);
+            Formula &f = formulas[target];
+            f.arena = arena;
+            f.value = value;
+            f.inputs = inputs;
+            f.dirty = f.busy = false;
+            for (set<string>::iterator i = inputs.begin(); i != inputs.end(); ++i)
+                dependents[*i].insert(target);
+
+            int result = value->evaluate(vars, funs);
+            vars.assign(target, result);
+            markDirty(target);
+            return result;
+        }
+    }
+
+    //  Not a formula -- whatever it assigns now has a fixed value
+    int result = root->evaluate(vars, funs);
+    for (set<string>::iterator a = assigned.begin(); a != assigned.end(); ++a)
+    {
+        forget(*a);
+        markDirty(*a);
+    }
+    delete arena;
+    return result;
+}
+
+//  invalidate
+//  Marks every formula dirty, as when a function they call is redefined
+void FormulaTable::invalidate()
+{
+    for (map<string, Formula>::iterator f = formulas.begin(); f != formulas.end(); ++f)
+        f->second.dirty = true;
+}
+
+//  refresh
+//  Recomputes a variable's formula if it is dirty, after first
+//  refreshing its inputs.  A formula that is reached again while it
+//  is being recomputed (a cycle) keeps the value it had.
+//  Parameters:
+//      name    (input string)          variable to bring up to date
+//      vars    (modified VarTree)      variables to work with
+//      funs    (input FunctionDef)     functions that may be called
+void FormulaTable::refresh( const string &name, VarTree &vars, FunctionDef &funs )
+{
+    map<string, Formula>::iterator found = formulas.find(name);
+    if (found == formulas.end() || !found->second.dirty || found->second.busy)
+        return;
+
+    Formula &f = found->second;
+    f.busy = true;
+    for (set<string>::iterator i = f.inputs.begin(); i != f.inputs.end(); ++i)
+        refresh(*i, vars, funs);
+    vars.assign(name, f.value->evaluate(vars, funs));
+    f.dirty = f.busy = false;
+    recomputed++;
+}
+
+//  markDirty
+//  Marks every formula that depends on a variable, directly or not
+//  Parameters:
+//      name    (input string)  variable whose value has changed
+void FormulaTable::markDirty( const string &name )
+{
+    map<string, set<string> >::iterator users = dependents.find(name);
+    if (users == dependents.end())
+        return;
+
+    for (set<string>::iterator u = users->second.begin(); u != users->second.end(); ++u)
+    {
+        Formula &f = formulas[*u];
+        if (!f.dirty)
+        {
+            f.dirty = true;
+            markDirty(*u);
+        }
+    }
+}
+
+//  forget
+//  Removes the formula for a variable, if it has one
+//  Parameters:
+//      name    (input string)  variable to remove the formula for
+void FormulaTable::forget( const string &name )
+{
+    map<string, Formula>::iterator found = formulas.find(name);
+    if (found == formulas.end())
+        return;
+
+    Formula &f = found->second;
+    for (set<string>::iterator i = f.inputs.begin(); i != f.inputs.end(); ++i)
+        dependents[*i].erase(name);
+    delete f.arena;
+    formulas.erase(found);
+}
@@ -0,0 +1,61 @@
+#ifndef FORMULA_H
+#define FORMULA_H
+// Formula Table Header File
+// Supports a reactive, spreadsheet-like style of evaluation.
+// An assignment such as
+//     Total = A + B
+// is remembered as a formula for Total, along with the variables
+// it depends on.  When A or B is later given a new value, Total is
+// only marked as out of date; it is recomputed the next time
+// anything reads it, and only if it is still out of date then.
+//
+// An assignment becomes a formula when its right side uses at least
+// one variable, does not use the variable being assigned, and does
+// not assign anything itself.  Any other assignment gives its
+// variable a fixed value, replacing any formula it had before.
+
+#include <map>
+#include <set>
+#include <string>
+using namespace std;
+
+#include "vartree.h"
+#include "funmap.h"
+#include "arena.h"
+
+class ExprNode;
+
+class FormulaTable
+{
+    private:
+        struct Formula
+        {
+            NodeArena *arena;           // holds the tree for this formula
+            const ExprNode *value;      // right side of the assignment
+            set<string> inputs;         // variables it uses
+            bool dirty;                 // an input has changed since it was computed
+            bool busy;                  // being recomputed (to cut off cycles)
+        };
+        map<string, Formula> formulas;              // formula for each variable
+        map<string, set<string> > dependents;       // formulas using each variable
+        int recomputed;                             // formulas recomputed so far
+
+        void refresh( const string&, VarTree&, FunctionDef& );
+        void markDirty( const string& );
+        void forget( const string& );
+
+        FormulaTable( const FormulaTable& );        // tables are never copied
+        FormulaTable& operator=( const FormulaTable& );
+    public:
+        FormulaTable()
+        {
+            recomputed = 0;
+        }
+        ~FormulaTable();
+        int evaluate( ExprNode *, NodeArena *, VarTree&, FunctionDef& );
+        void invalidate();
+        int recomputeCount() const { return recomputed; }
+        int size() const { return formulas.size(); }
+};
+
+#endif
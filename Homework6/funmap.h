@@ -10,13 +10,39 @@
 
 class ExprNode;				// declaring class names
 class VarTree;				// for use below
+class NodeArena;
 struct FunDef
 {
     string	name;			// name of the function
     string	parameter[10];		// parameter list
     VarTree    *locals;			// parameters and local variables
-    ExprNode   *functionBody;		// code for the function
+    ExprNode   *functionBody;		// code for the function,
+					// or NULL if it is not yet defined
+    NodeArena  *nodes;			// holds the body, until the function
+					// is defined again
+    FunDef()
+    {
+        locals = NULL;
+        functionBody = NULL;
+        nodes = NULL;
+    }
 };
 
 typedef map<string, struct FunDef> FunctionDef;
+
+// bindFunction
+// Finds the definition a call to the named function will refer to
+// A function called before it is defined gets an empty definition
+// (with no body) right away, to be filled in when it is defined;
+// its FunDef stays at the same place in the map ever after.
+// Parameters:
+//     funs   (modified FunctionDef)  functions defined so far
+//     name   (input string)          name of the function
+// Returns:    that function's definition
+inline FunDef* bindFunction( FunctionDef& funs, const string& name )
+{
+    FunDef* function = &funs[name];
+    function->name = name;
+    return function;
+}
 #endif
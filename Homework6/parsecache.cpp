@@ -0,0 +1,109 @@
+// Parse Cache Implementation File
+// The cache is a map from normalized text to tree, together with a
+// list of the same texts in order of use, so that the least recently
+// used one is always at the back.  Each tree has an arena of its own,
+// which is deleted when the tree leaves the cache.
+
+#include <ctype.h>
+using namespace std;
+
+#include "parsecache.h"
+
+ParseCache::~ParseCache()
+{
+    clear();
+}
+
+//  normalize
+//  Produces the key for an expression text: leading and trailing
+//  white space is dropped, and any other run of it becomes one space
+//  (a space may still separate two tokens, as in "< =")
+//  Parameters:
+//      str     (input char array)  expression text
+//  Returns:    the normalized text
+string ParseCache::normalize( const char str[] )
+{
+    string key;
+    bool space = false;
+    for (const char *c = str; *c != '\0'; ++c)
+    {
+        if (isspace((unsigned char) *c))
+            space = !key.empty();
+        else
+        {
+            if (space)
+                key += ' ';
+            key += *c;
+            space = false;
+        }
+    }
+    return key;
+}
+
+//  lookup
+//  Finds the tree for a normalized text, and marks it most recently used
+//  Parameters:
+//      key     (input string)  normalized expression text
+//  Returns:    the cached tree, or NULL if there is none
+ExprNode* ParseCache::lookup( const string &key )
+{
+    map<string, Entry>::iterator found = entries.find(key);
+    if (found == entries.end())
+    {
+        missCount++;
+        return NULL;
+    }
+    hitCount++;
+    recent.splice(recent.begin(), recent, found->second.age);
+    return found->second.root;
+}
+
+//  insert
+//  Adds a newly parsed tree to the cache, which takes over its arena
+//  (the text must not be in the cache already)
+//  Parameters:
+//      key     (input string)          normalized expression text
+//      root    (input ExprNode ptr)    tree parsed from that text
+//      arena   (input NodeArena ptr)   arena holding that tree alone
+void ParseCache::insert( const string &key, ExprNode *root, NodeArena *arena )
+{
+    recent.push_front(key);
+    Entry &e = entries[key];
+    e.root = root;
+    e.arena = arena;
+    e.age = recent.begin();
+    evict();
+}
+
+//  evict
+//  Drops the least recently used trees until the cache is within its limit
+void ParseCache::evict()
+{
+    while (entries.size() > limit)
+    {
+        map<string, Entry>::iterator oldest = entries.find(recent.back());
+        delete oldest->second.arena;
+        entries.erase(oldest);
+        recent.pop_back();
+    }
+}
+
+//  clear
+//  Drops every tree, leaving the statistics alone
+void ParseCache::clear()
+{
+    for (map<string, Entry>::iterator e = entries.begin(); e != entries.end(); ++e)
+        delete e->second.arena;
+    entries.clear();
+    recent.clear();
+}
+
+//  setCapacity
+//  Changes how many trees the cache may hold, dropping any extra ones
+//  Parameters:
+//      capacity (input size_t) most trees to keep
+void ParseCache::setCapacity( size_t capacity )
+{
+    limit = capacity;
+    evict();
+}
@@ -0,0 +1,62 @@
+#ifndef PARSECACHE_H
+#define PARSECACHE_H
+// Parse Cache Header File
+// Batch input tends to evaluate the same few expression texts over
+// and over, with only the values of the variables changing between
+// them.  This cache remembers the tree parsed from each text, so a
+// repeated text need not be tokenized or parsed again.
+//
+// Texts are compared after normalizing their white space, and the
+// least recently used tree is dropped once the cache is full.
+// A call in a tree points at its function's FunDef, which stays at the
+// same place in the function table for the whole run (see funmap.h).
+// Redefining the function replaces the body inside that FunDef, and
+// the call looks the body up when it is evaluated, so a cached tree
+// is never out of date and never points at a freed body.
+
+#include <list>
+#include <map>
+#include <string>
+using namespace std;
+
+#include "arena.h"
+
+class ExprNode;
+
+class ParseCache
+{
+    private:
+        struct Entry
+        {
+            ExprNode *root;             // the parsed tree
+            NodeArena *arena;           // the arena holding it
+            list<string>::iterator age; // place in the recently used list
+        };
+        map<string, Entry> entries;     // tree for each normalized text
+        list<string> recent;            // texts, most recently used first
+        size_t limit;                   // most trees to keep
+        long long hitCount, missCount;
+
+        void evict();
+
+        ParseCache( const ParseCache& );            // caches are never copied
+        ParseCache& operator=( const ParseCache& );
+    public:
+        ParseCache( size_t capacity = 1000 )
+        {
+            limit = capacity;
+            hitCount = missCount = 0;
+        }
+        ~ParseCache();
+        static string normalize( const char str[] );
+        ExprNode* lookup( const string& );
+        void insert( const string&, ExprNode *, NodeArena * );
+        void clear();
+        void setCapacity( size_t );
+        size_t capacity() const { return limit; }
+        size_t size() const { return entries.size(); }
+        long long hits() const { return hitCount; }
+        long long misses() const { return missCount; }
+};
+
+#endif
@@ -0,0 +1,36 @@
+// Character Scanner Implementation File
+// Just the table of character classes, sixteen characters to a row.
+
+#include "scanner.h"
+
+#define E CHAR_END
+#define S CHAR_SPACE
+#define D CHAR_DIGIT
+#define O CHAR_OPER
+#define N CHAR_NAME
+
+const unsigned char charClass[256] =
+{
+    E, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // 00
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // 10
+    S, O, N, N, N, O, N, N, O, O, O, O, O, O, N, O,   // 20   ! % ( ) * + , - /
+    D, D, D, D, D, D, D, D, D, D, O, N, O, O, O, O,   // 30   0-9 : < = > ?
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // 40
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // 50
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // 60
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // 70
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // 80
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // 90
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // a0
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // b0
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // c0
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // d0
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // e0
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,   // f0
+};
+
+#undef E
+#undef S
+#undef D
+#undef O
+#undef N
@@ -0,0 +1,116 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+// Character Scanner Header File
+// The tokenizer sorts every character into one of a few classes with
+// a single table lookup, instead of a chain of comparisons:
+//     CHAR_NAME   anything that may appear in a variable name
+//     CHAR_SPACE  a blank, which separates tokens
+//     CHAR_DIGIT  0 to 9, starting a number (but allowed in a name)
+//     CHAR_OPER   one of  + - * / % ( ) = , < > ! ? :
+//     CHAR_END    the terminating null character
+//
+// Runs of blanks and of letters are skipped 16 (or with AVX2, 32)
+// bytes at a time where the processor supports it.  Those fast paths
+// may read a little past the end of the string, but never onto
+// another page of memory, so they cannot fault.  (Address sanitizers
+// are told not to check them.)
+
+#include <stddef.h>
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+enum CharClass
+{
+    CHAR_NAME, CHAR_SPACE, CHAR_DIGIT, CHAR_OPER, CHAR_END
+};
+
+extern const unsigned char charClass[256];
+
+inline int classOf( char c )
+{
+    return charClass[(unsigned char) c];
+}
+
+const size_t PAGE_SIZE = 4096;
+
+#if defined(__GNUC__)
+#define READS_PAST_END __attribute__((no_sanitize_address))
+#else
+#define READS_PAST_END
+#endif
+
+// safeToRead
+// Whether n bytes may be read starting at p without crossing a page
+inline bool safeToRead( const char *p, size_t n )
+{
+    return ((uintptr_t) p & (PAGE_SIZE - 1)) <= PAGE_SIZE - n;
+}
+
+// skipBlanks
+// Returns a pointer to the first character at or after p
+// that is not a blank
+READS_PAST_END inline const char *skipBlanks( const char *p )
+{
+#if defined(__AVX2__)
+    const __m256i blank32 = _mm256_set1_epi8(' ');
+    while (safeToRead(p, 32))
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) p);
+        unsigned others = ~(unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, blank32));
+        if (others != 0)
+            return p + __builtin_ctz(others);
+        p += 32;
+    }
+#elif defined(__SSE2__)
+    const __m128i blank16 = _mm_set1_epi8(' ');
+    while (safeToRead(p, 16))
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) p);
+        unsigned others = ~_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, blank16)) & 0xFFFF;
+        if (others != 0)
+            return p + __builtin_ctz(others);
+        p += 16;
+    }
+#endif
+    while (*p == ' ')
+        ++p;
+    return p;
+}
+
+// skipLetters
+// Returns a pointer to the first character at or after p that is
+// below '@' in the character set.  Everything from '@' up is part
+// of a name, so only what is below it needs looking up in the table.
+READS_PAST_END inline const char *skipLetters( const char *p )
+{
+#if defined(__AVX2__)
+    const __m256i at32 = _mm256_set1_epi8('@');
+    while (safeToRead(p, 32))
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) p);
+        __m256i high = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, at32), chunk);
+        unsigned low = ~(unsigned) _mm256_movemask_epi8(high);
+        if (low != 0)
+            return p + __builtin_ctz(low);
+        p += 32;
+    }
+#elif defined(__SSE2__)
+    const __m128i at16 = _mm_set1_epi8('@');
+    while (safeToRead(p, 16))
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) p);
+        __m128i high = _mm_cmpeq_epi8(_mm_max_epu8(chunk, at16), chunk);
+        unsigned low = ~_mm_movemask_epi8(high) & 0xFFFF;
+        if (low != 0)
+            return p + __builtin_ctz(low);
+        p += 16;
+    }
+#endif
+    while ((unsigned char) *p >= '@')
+        ++p;
+    return p;
+}
+
+#endif
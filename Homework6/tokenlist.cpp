@@ -8,6 +8,9 @@
 #include <string.h>
 #include <ctype.h>
 
+// A table classifying every character, and fast ways to skip blanks and letters
+#include "scanner.h"
+
 // And to get the definition of a token:
 #include "tokenlist.h"
 
@@ -15,6 +18,8 @@ bool isOperator(char c);
 
 // TokenList constructor
 // converts a character string into a list of tokens
+// Each character is classified with one table lookup (see scanner.h),
+// and numbers are converted in the same pass that finds them.
 // Parameter:
 //     expr    (input char pointer)    // string to examine
 // Pre-condition:  str may not be a null pointer
@@ -25,55 +30,57 @@ TokenList::TokenList( const char expr[])
     tail = NULL;
     head = NULL;
 
-    int position = 0;
-    
     //Go past any initial spaces
-    while (expr[position] == ' ')
-        ++position;
+    const char *position = skipBlanks(expr);
 
     //Go until we hit a null character
-    while (expr[position] != '\0')
+    while (*position != '\0')
     {
-        if (isdigit(expr[position]))
-        {
-            Token t(atoi(&expr[position]));
-            push_back(t);
-            while (isdigit(expr[position]))
-                ++position;
-        }
-        else if (isOperator(expr[position]))
+        switch (classOf(*position))
         {
-            string charstring;
-            charstring += expr[position];
-            ++position;
-
-            //This next bit will take care of 2 character operations (>=, <=, !=, ==)
-            //I have this rather than a while loop to keep the program from swallowing long strings
-            //of operators, such as in A=(B+C), where =( would be treated as one operator.
-            if (expr[position] == '=' && expr[position - 1] != ')')
+        case CHAR_DIGIT:
             {
-                charstring += expr[position];
-                ++position;
+                //The value is built up as the digits go by, rather than rescanning them
+                int value = 0;
+                do
+                    value = value * 10 + (*position++ - '0');
+                while (classOf(*position) == CHAR_DIGIT);
+                push_back(Token(value));
             }
+            break;
 
-            Token t(charstring);
-            push_back(t);
-        }
-        else
-        {
-            string charstring;
-            while (expr[position] != ' ' && expr[position] != '\0' && !isOperator(expr[position]))
+        case CHAR_OPER:
+            {
+                const char *start = position++;
+
+                //This next bit will take care of 2 character operations (>=, <=, !=, ==)
+                //I have this rather than a while loop to keep the program from swallowing long strings
+                //of operators, such as in A=(B+C), where =( would be treated as one operator.
+                if (*position == '=' && *start != ')')
+                    ++position;
+
+                push_back(Token(string(start, position - start)));
+            }
+            break;
+
+        default:
             {
-                charstring += expr[position];
-                ++position;
+                //A name runs up to the next space, operator or the end, and may contain digits
+                const char *start = position;
+                for (;;)
+                {
+                    position = skipLetters(position);
+                    int next = classOf(*position);
+                    if (next != CHAR_NAME && next != CHAR_DIGIT)
+                        break;
+                    ++position;
+                }
+                push_back(Token(string(start, position - start)));
             }
-            Token t(charstring);
-            push_back(t);
         }
 
         //Advance to next token if we're on spaces
-        while (expr[position] == ' ')
-            ++position;
+        position = skipBlanks(position);
     }
 }
 
@@ -86,9 +93,7 @@ TokenList::TokenList( const char expr[])
 //     (bool) - whether or not the character is recognized as an operator
 bool isOperator(char c)
 {
-    return (c == '+' || c == '-' || c == '*' || c == '/' || c == '%' || 
-            c == '(' || c == ')' || c == '=' || c == ',' || c == '<' ||
-            c == '>' || c == '!' || c == '?' || c == ':');
+    return classOf(c) == CHAR_OPER;
 }
 
 //  output operation
@@ -118,7 +123,7 @@ ListIterator TokenList::end()
 //  Add a new element to the back of the list
 //  Parameter:
 //       t    (input Token)    the new item to add
-void TokenList::push_back(Token t)
+void TokenList::push_back(const Token& t)
 {
     ListElement* newElement = new ListElement();
     newElement->token = t;
@@ -140,7 +145,7 @@ void TokenList::push_back(Token t)
 //  Add a new element to the front of the list
 //  Parameter:
 //       t    (input Token)    the new item to add
-void TokenList::push_front(Token t)
+void TokenList::push_front(const Token& t)
 {
     ListElement* newElement = new ListElement();
     newElement->token = t;
@@ -53,8 +53,8 @@ class TokenList  {
         return head->token;
     }
 
-    void push_back( Token t );
-    void push_front( Token t );
+    void push_back( const Token& t );
+    void push_front( const Token& t );
     Token pop_front();
 
     // and now some support for the List Iterator
@@ -41,6 +41,25 @@ TreeNode* VarTree::recursiveSearch( TreeNode *&node, string name )
     return node;        
 }
 
+//  destroy
+//  Deletes every node in a sub-tree
+//  Parameters:
+//      node    (input TreeNode ptr)    root of sub-tree to delete
+void VarTree::destroy( TreeNode *node )
+{
+    if (node != NULL)
+    {
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+}
+
+VarTree::~VarTree()
+{
+    destroy(root);
+}
+
 //  lookup
 //  Searches for a variable to get its value
 //  If the variable does not yet exist, it is created with value 0.
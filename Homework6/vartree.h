@@ -1,3 +1,6 @@
+#ifndef VARTREE_H
+#define VARTREE_H
+
 // Variable Tree Header File
 // A symbol table for variables will be represented here with 
 // a binary tree, associating variable names with integer variables.
@@ -40,10 +43,16 @@ class VarTree
     {
         root = NULL;    // empty tree
     }
+    ~VarTree();
     void assign( string, int );
     int lookup( string );
 
     private:        // these just help VarTree do its job
     TreeNode* recursiveSearch( TreeNode *&, string );
+    void destroy( TreeNode * );
+    VarTree( const VarTree& );                  // trees are never copied
+    VarTree& operator=( const VarTree& );
 };
 
+
+#endif
@@ -0,0 +1,133 @@
+// Allocation Tracking Implementation File
+// Replaces the global operator new and delete with versions that
+// keep a small header in front of every block, recording its size
+// and the subsystem that allocated it, so that frees are charged
+// back to the same subsystem.
+//
+// Nothing here is compiled unless TRACK_ALLOC is defined.
+
+#ifdef TRACK_ALLOC
+
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <stdlib.h>
+#include <stddef.h>
+using namespace std;
+
+#include "alloctrack.h"
+
+int currentSubsystem = ALLOC_OTHER;
+
+// Counters kept for each subsystem
+struct AllocStats
+{
+    long long allocations;  // blocks allocated
+    long long frees;        // blocks freed
+    long long bytes;        // bytes allocated in total
+    long long live;         // bytes currently allocated
+    long long peak;         // most bytes allocated at once
+};
+
+static AllocStats stats[ALLOC_SUBSYSTEMS];
+
+// The header in front of every block, padded so the block
+// itself stays suitably aligned for any type
+union BlockHeader
+{
+    struct
+    {
+        size_t size;
+        int subsystem;
+    } info;
+    max_align_t align;
+};
+
+static const char *subsystemNames[ALLOC_SUBSYSTEMS] =
+{
+    "other", "tokenizer", "parser", "tree", "symbols", "codegen", "machine"
+};
+
+// allocationReport
+// Prints the counters for every subsystem that allocated anything
+static void allocationReport( ostream &stream )
+{
+    stream << endl << "Allocations by subsystem:" << endl;
+    stream << left << setw(12) << "subsystem" << right << setw(12) << "allocs"
+           << setw(14) << "bytes" << setw(14) << "peak live" << setw(12) << "leaked"
+           << setw(14) << "leaked bytes" << endl;
+    for (int i = 0; i < ALLOC_SUBSYSTEMS; ++i)
+    {
+        if (stats[i].allocations == 0)
+            continue;
+        stream << left << setw(12) << subsystemNames[i] << right
+               << setw(12) << stats[i].allocations << setw(14) << stats[i].bytes
+               << setw(14) << stats[i].peak
+               << setw(12) << stats[i].allocations - stats[i].frees
+               << setw(14) << stats[i].live << endl;
+    }
+}
+
+// Prints the report once everything else has finished
+static struct ReportAtExit
+{
+    ~ReportAtExit()
+    {
+        allocationReport(cerr);
+    }
+} reportAtExit;
+
+void* operator new( size_t size )
+{
+    BlockHeader *header = (BlockHeader *) malloc(sizeof(BlockHeader) + size);
+    if (header == NULL)
+        throw bad_alloc();
+
+    int subsystem = currentSubsystem;
+    header->info.size = size;
+    header->info.subsystem = subsystem;
+
+    AllocStats &s = stats[subsystem];
+    s.allocations++;
+    s.bytes += size;
+    s.live += size;
+    if (s.live > s.peak)
+        s.peak = s.live;
+
+    return header + 1;
+}
+
+void* operator new[]( size_t size )
+{
+    return operator new(size);
+}
+
+void operator delete( void *p ) noexcept
+{
+    if (p == NULL)
+        return;
+
+    BlockHeader *header = (BlockHeader *) p - 1;
+    AllocStats &s = stats[header->info.subsystem];
+    s.frees++;
+    s.live -= header->info.size;
+
+    free(header);
+}
+
+void operator delete[]( void *p ) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete( void *p, size_t ) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete[]( void *p, size_t ) noexcept
+{
+    operator delete(p);
+}
+
+#endif
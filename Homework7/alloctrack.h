@@ -0,0 +1,56 @@
+#ifndef ALLOCTRACK_H
+#define ALLOCTRACK_H
+// Allocation Tracking Header
+// When compiled with -DTRACK_ALLOC (see "make alloc"), every use of
+// operator new and delete is counted, and charged to whichever part
+// of the program was running at the time.  A report of allocations,
+// bytes, peak live bytes and leaked blocks for each subsystem is
+// printed to cerr when the program exits.
+//
+// A function marks itself as part of a subsystem with
+//     ALLOC_SCOPE( ALLOC_PARSER );
+// which lasts until the end of the enclosing block, and then restores
+// whatever subsystem was running before.  Without -DTRACK_ALLOC the
+// macro does nothing at all, so the hooks cost nothing.
+
+enum Subsystem
+{
+    ALLOC_OTHER,        // anything not marked below
+    ALLOC_TOKENIZER,    // building token lists
+    ALLOC_PARSER,       // building expression trees
+    ALLOC_TREE,         // evaluating expression trees
+    ALLOC_SYMBOLS,      // variable and function tables
+    ALLOC_CODEGEN,      // generating machine instructions
+    ALLOC_MACHINE,      // listing and running the machine
+    ALLOC_SUBSYSTEMS    // (number of subsystems)
+};
+
+#ifdef TRACK_ALLOC
+
+extern int currentSubsystem;
+
+class AllocScope
+{
+    private:
+        int saved;      // subsystem to go back to
+    public:
+        AllocScope( int subsystem )
+        {
+            saved = currentSubsystem;
+            currentSubsystem = subsystem;
+        }
+        ~AllocScope()
+        {
+            currentSubsystem = saved;
+        }
+};
+
+#define ALLOC_SCOPE(subsystem) AllocScope allocScope(subsystem)
+
+#else
+
+#define ALLOC_SCOPE(subsystem) do { } while (0)
+
+#endif
+
+#endif
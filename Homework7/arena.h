@@ -0,0 +1,42 @@
+#ifndef ARENA_H
+#define ARENA_H
+// Node Arena Header File
+// Expression tree nodes are not allocated one at a time from the heap.
+// Instead, they are laid out one after another in large chunks of
+// memory, in the order the parser creates them, and a whole tree is
+// released at once when it is no longer needed.
+//
+// A node is placed in an arena with
+//     new (arena) Operation( left, "+", right )
+// and release() runs the destructor of every node placed there since
+// the last release, and keeps the chunks to hold the next tree.
+// Plain data belonging to the nodes, such as the arguments of a call,
+// may be kept there too, and is released along with them.
+// The chunks are only returned to the heap when the arena is destroyed.
+
+#include <stddef.h>
+
+class NodeArena
+{
+    private:
+        struct Chunk;           // a block of memory holding many nodes
+        Chunk *first,           // chunks, in the order they were obtained
+              *current;         // the chunk now being filled
+        size_t chunkSize;       // bytes in an ordinary chunk
+        size_t count;           // nodes allocated since the last release
+
+        Chunk* newChunk( size_t );
+
+        NodeArena( const NodeArena& );              // arenas are never copied
+        NodeArena& operator=( const NodeArena& );
+    public:
+        NodeArena( size_t size = 16384 );
+        ~NodeArena();
+        void *allocate( size_t );
+        void *allocatePlain( size_t );  // for data that is not a node
+        void discard( void * );
+        void release();
+        size_t size() const { return count; }
+};
+
+#endif
@@ -0,0 +1,278 @@
+// Big Integer Implementation File
+// The general cases of the arithmetic, for when a value or a result
+// does not fit in a long long.  Each works on the magnitudes of its
+// operands as digit lists in base one billion, and then puts the sign
+// back, returning to the small form whenever the result allows.
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <signal.h>
+using namespace std;
+
+#include "bigint.h"
+
+typedef vector<unsigned> Digits;
+const unsigned BASE = 1000000000;
+
+//  trim
+//  Drops leading zero digits (which are at the back)
+static void trim( Digits &a )
+{
+    while (!a.empty() && a.back() == 0)
+        a.pop_back();
+}
+
+//  compareDigits
+//  Compares two magnitudes, neither with any leading zeros
+//  Returns:    negative, zero or positive as a is less, equal or greater
+static int compareDigits( const Digits &a, const Digits &b )
+{
+    if (a.size() != b.size())
+        return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0; )
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    return 0;
+}
+
+//  addDigits
+//  Returns:    the sum of two magnitudes
+static Digits addDigits( const Digits &a, const Digits &b )
+{
+    Digits sum;
+    unsigned carry = 0;
+    for (size_t i = 0; i < a.size() || i < b.size() || carry != 0; ++i)
+    {
+        unsigned d = carry;
+        if (i < a.size()) d += a[i];
+        if (i < b.size()) d += b[i];
+        carry = d >= BASE;
+        sum.push_back( carry ? d - BASE : d );
+    }
+    return sum;
+}
+
+//  subtractDigits
+//  Returns:    the difference of two magnitudes, the first not the smaller
+static Digits subtractDigits( const Digits &a, const Digits &b )
+{
+    Digits diff( a );
+    unsigned borrow = 0;
+    for (size_t i = 0; i < diff.size() && (i < b.size() || borrow != 0); ++i)
+    {
+        unsigned take = borrow + (i < b.size() ? b[i] : 0);
+        borrow = diff[i] < take;
+        diff[i] = borrow ? diff[i] + BASE - take : diff[i] - take;
+    }
+    trim( diff );
+    return diff;
+}
+
+//  multiplyDigits
+//  Long multiplication, one digit of the first by all of the second
+//  Returns:    the product of two magnitudes
+static Digits multiplyDigits( const Digits &a, const Digits &b )
+{
+    Digits product( a.size() + b.size(), 0 );
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        unsigned long long carry = 0;
+        for (size_t j = 0; j < b.size(); ++j)
+        {
+            unsigned long long d = product[i+j] + (unsigned long long) a[i] * b[j] + carry;
+            product[i+j] = d % BASE;
+            carry = d / BASE;
+        }
+        product[i + b.size()] = carry;
+    }
+    trim( product );
+    return product;
+}
+
+//  divideDigits
+//  Long division, one digit of the quotient at a time, each found
+//  by a binary search (or directly, for a divisor of one digit)
+//  Parameters:
+//      a, b        (input Digits)      dividend and nonzero divisor
+//      quotient    (output Digits)     the quotient
+//      remainder   (output Digits)     the remainder
+static void divideDigits( const Digits &a, const Digits &b,
+        Digits &quotient, Digits &remainder )
+{
+    quotient.assign( a.size(), 0 );
+    remainder.clear();
+    if (b.size() == 1)
+    {
+        unsigned long long r = 0;
+        for (size_t i = a.size(); i-- > 0; )
+        {
+            r = r * BASE + a[i];
+            quotient[i] = r / b[0];
+            r %= b[0];
+        }
+        if (r != 0)
+            remainder.push_back( r );
+        trim( quotient );
+        return;
+    }
+
+    for (size_t i = a.size(); i-- > 0; )
+    {
+        remainder.insert( remainder.begin(), a[i] );
+        trim( remainder );
+        unsigned low = 0, high = BASE - 1;
+        while (low < high)
+        {
+            unsigned mid = low + (high - low + 1) / 2;
+            if (compareDigits( multiplyDigits( b, Digits( 1, mid ) ), remainder ) <= 0)
+                low = mid;
+            else
+                high = mid - 1;
+        }
+        if (low != 0)
+            remainder = subtractDigits( remainder, multiplyDigits( b, Digits( 1, low ) ) );
+        quotient[i] = low;
+    }
+    trim( quotient );
+}
+
+//  magnitude
+//  Produces the absolute value as a digit list
+//  Parameters:
+//      mag     (output Digits)     the digits
+void BigInt::magnitude( Digits &mag ) const
+{
+    if (!isSmall())
+    {
+        mag = digits;
+        return;
+    }
+    mag.clear();
+    unsigned long long m = small < 0 ? 0ULL - (unsigned long long) small : small;
+    while (m != 0)
+    {
+        mag.push_back( m % BASE );
+        m /= BASE;
+    }
+}
+
+//  make
+//  Builds a value from a sign and a magnitude, in the small form
+//  whenever it will fit in a long long
+//  Parameters:
+//      mag     (modified Digits)   the magnitude (its digits are taken)
+//      neg     (input boolean)     whether the value is negative
+BigInt BigInt::make( Digits &mag, bool neg )
+{
+    trim( mag );
+    unsigned long long m = 0;
+    bool fits = mag.size() <= 3;
+    for (size_t i = mag.size(); fits && i-- > 0; )
+        fits = !__builtin_mul_overflow( m, BASE, &m ) && !__builtin_add_overflow( m, mag[i], &m );
+
+    if (fits && (!neg || m == 0) && m <= (unsigned long long) LLONG_MAX)
+        return BigInt( m );
+    if (fits && neg && m - 1 <= (unsigned long long) LLONG_MAX)
+        return BigInt( -(long long)(m - 1) - 1 );
+
+    BigInt result;
+    result.negative = neg;
+    result.digits.swap( mag );
+    return result;
+}
+
+//  add
+//  Adds or subtracts any two values
+//  Parameters:
+//      a, b        (input BigInt)      the operands
+//      subtract    (input boolean)     whether to find a - b instead
+BigInt BigInt::add( const BigInt &a, const BigInt &b, bool subtract )
+{
+    Digits ma, mb;
+    a.magnitude( ma );
+    b.magnitude( mb );
+    bool signA = a.sign(),
+         signB = b.sign() != subtract;
+
+    Digits result;
+    if (signA == signB)
+        result = addDigits( ma, mb );
+    else if (compareDigits( ma, mb ) >= 0)
+        result = subtractDigits( ma, mb );
+    else
+    {
+        result = subtractDigits( mb, ma );
+        signA = signB;
+    }
+    return make( result, signA );
+}
+
+BigInt BigInt::multiply( const BigInt &a, const BigInt &b )
+{
+    Digits ma, mb;
+    a.magnitude( ma );
+    b.magnitude( mb );
+    Digits result = multiplyDigits( ma, mb );
+    return make( result, a.sign() != b.sign() );
+}
+
+//  divide
+//  Divides any two values, truncating toward zero
+//  Parameters:
+//      a, b        (input BigInt)      dividend and divisor
+//      remainder   (input boolean)     whether the remainder is wanted
+BigInt BigInt::divide( const BigInt &a, const BigInt &b, bool remainder )
+{
+    Digits ma, mb, q, r;
+    a.magnitude( ma );
+    b.magnitude( mb );
+    if (mb.empty())
+    {
+        raise( SIGFPE );                // as an int division would
+        return BigInt();
+    }
+    divideDigits( ma, mb, q, r );
+    if (remainder)
+        return make( r, a.sign() );     // takes the sign of the dividend
+    return make( q, a.sign() != b.sign() );
+}
+
+int BigInt::compare( const BigInt &a, const BigInt &b )
+{
+    if (a.sign() != b.sign())
+        return a.sign() ? -1 : 1;
+    Digits ma, mb;
+    a.magnitude( ma );
+    b.magnitude( mb );
+    int c = compareDigits( ma, mb );
+    return a.sign() ? -c : c;
+}
+
+long long BigInt::toLongLong() const
+{
+    return small;
+}
+
+string BigInt::toString() const
+{
+    ostringstream convert;
+    convert << *this;
+    return convert.str();
+}
+
+//  A large value is written as its most significant digit, and then
+//  each of the others padded out to nine decimal places
+ostream& operator<<( ostream &stream, const BigInt &b )
+{
+    if (b.isSmall())
+        return stream << b.small;
+
+    ostringstream convert;
+    if (b.negative)
+        convert << '-';
+    convert << b.digits.back();
+    for (size_t i = b.digits.size() - 1; i-- > 0; )
+        convert << setw(9) << setfill('0') << b.digits[i];
+    return stream << convert.str();
+}
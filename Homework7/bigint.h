@@ -0,0 +1,139 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+// Big Integer Header File
+// An integer of any size at all.  Nearly every value in practice is
+// small, so a value that fits in a long long is held right inside the
+// object, and arithmetic on two such values is done directly, merely
+// checking for overflow -- nothing is allocated.
+// Only a result that does not fit is kept as a list of digits in base
+// one billion (least significant first) and handled by the slower
+// general algorithms.  Any result that fits again goes back inside.
+//
+// Division and remainder truncate toward zero, as they do for int,
+// and dividing by zero raises the same signal that it does for int.
+
+#include <climits>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class BigInt
+{
+    private:
+        long long small;            // the value, while it fits here
+        bool negative;              // sign of a large value
+        vector<unsigned> digits;    // magnitude of a large value, else empty
+
+        bool sign() const
+        {
+            return isSmall() ? small < 0 : negative;
+        }
+        void magnitude( vector<unsigned> & ) const;
+        static BigInt make( vector<unsigned> &, bool );
+
+        // the general cases, when the fast paths below do not apply
+        static BigInt add( const BigInt&, const BigInt&, bool );
+        static BigInt multiply( const BigInt&, const BigInt& );
+        static BigInt divide( const BigInt&, const BigInt&, bool );
+        static int compare( const BigInt&, const BigInt& );
+
+    public:
+        BigInt( long long v = 0 )
+        {
+            small = v;
+            negative = false;
+        }
+
+        bool isSmall() const
+        {
+            return digits.empty();
+        }
+        long long toLongLong() const;   // only meaningful when isSmall()
+        string toString() const;
+
+        explicit operator bool() const
+        {
+            return !isSmall() || small != 0;
+        }
+
+        friend BigInt operator-( const BigInt & );
+        friend BigInt operator+( const BigInt &, const BigInt & );
+        friend BigInt operator-( const BigInt &, const BigInt & );
+        friend BigInt operator*( const BigInt &, const BigInt & );
+        friend BigInt operator/( const BigInt &, const BigInt & );
+        friend BigInt operator%( const BigInt &, const BigInt & );
+        friend bool operator==( const BigInt &, const BigInt & );
+        friend bool operator<( const BigInt &, const BigInt & );
+        friend ostream& operator<<( ostream &, const BigInt & );
+};
+
+inline BigInt operator-( const BigInt &a )
+{
+    if (a.isSmall() && a.small != LLONG_MIN)
+        return BigInt( -a.small );
+    return BigInt::add( BigInt(), a, true );
+}
+
+inline BigInt operator+( const BigInt &a, const BigInt &b )
+{
+    long long result;
+    if (a.isSmall() && b.isSmall() && !__builtin_add_overflow( a.small, b.small, &result ))
+        return BigInt( result );
+    return BigInt::add( a, b, false );
+}
+
+inline BigInt operator-( const BigInt &a, const BigInt &b )
+{
+    long long result;
+    if (a.isSmall() && b.isSmall() && !__builtin_sub_overflow( a.small, b.small, &result ))
+        return BigInt( result );
+    return BigInt::add( a, b, true );
+}
+
+inline BigInt operator*( const BigInt &a, const BigInt &b )
+{
+    long long result;
+    if (a.isSmall() && b.isSmall() && !__builtin_mul_overflow( a.small, b.small, &result ))
+        return BigInt( result );
+    return BigInt::multiply( a, b );
+}
+
+//  Only a zero divisor, or the one quotient too large for a long long,
+//  needs more care than the processor's own division
+inline BigInt operator/( const BigInt &a, const BigInt &b )
+{
+    if (a.isSmall() && b.isSmall() &&
+            (b.small > 0 || (b.small < 0 && a.small != LLONG_MIN)))
+        return BigInt( a.small / b.small );
+    return BigInt::divide( a, b, false );
+}
+
+inline BigInt operator%( const BigInt &a, const BigInt &b )
+{
+    if (a.isSmall() && b.isSmall() &&
+            (b.small > 0 || (b.small < 0 && a.small != LLONG_MIN)))
+        return BigInt( a.small % b.small );
+    return BigInt::divide( a, b, true );
+}
+
+inline bool operator==( const BigInt &a, const BigInt &b )
+{
+    if (a.isSmall() && b.isSmall())
+        return a.small == b.small;
+    return BigInt::compare( a, b ) == 0;
+}
+
+inline bool operator<( const BigInt &a, const BigInt &b )
+{
+    if (a.isSmall() && b.isSmall())
+        return a.small < b.small;
+    return BigInt::compare( a, b ) < 0;
+}
+
+inline bool operator!=( const BigInt &a, const BigInt &b ) { return !(a == b); }
+inline bool operator>( const BigInt &a, const BigInt &b )  { return b < a; }
+inline bool operator<=( const BigInt &a, const BigInt &b ) { return !(b < a); }
+inline bool operator>=( const BigInt &a, const BigInt &b ) { return !(a < b); }
+
+#endif
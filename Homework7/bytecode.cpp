@@ -0,0 +1,446 @@
+// Bytecode Implementation File
+// Generating the code for the stack machine of bytecode.h, running
+// it, and listing it.
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+
+#include "bytecode.h"
+#include "exprtree.h"
+#include "checked.h"
+#include "sink.h"
+
+//  How each instruction changes the depth of the stack (a call is
+//  worked out from its number of arguments)
+static const signed char stackEffect[OP_COUNT] =
+{
+    0,                  // OP_HALT
+    1, 1,               // OP_CONST, OP_BIG
+    1, 0, 1, 0,         // OP_LOAD, OP_STORE, OP_LOAD_LOCAL, OP_STORE_LOCAL
+    -1, -1, -1, -1, -1, // arithmetic
+    -1, -1, -1, -1, -1, -1,     // comparisons
+    0, -1,              // OP_JUMP, OP_JUMP_FALSE
+    1,                  // OP_CALL, before its arguments are taken
+    -1, -1              // OP_RETURN, OP_PRINT
+};
+
+static const char *mnemonic[OP_COUNT] =
+{
+    "halt", "const", "const", "load", "store", "lload", "lstore",
+    "add", "sub", "mul", "div", "mod",
+    "lt", "gt", "le", "ge", "eq", "ne",
+    "jump", "jumpf", "call", "return", "print"
+};
+
+//  zigzag, unzigzag
+//  Map 0, -1, 1, -2, 2 ... to 0, 1, 2, 3, 4 ... and back
+static inline unsigned long long zigzag( long long n )
+{
+    return ((unsigned long long) n << 1) ^ (unsigned long long) (n >> 63);
+}
+
+static inline long long unzigzag( unsigned long long u )
+{
+    return (long long) (u >> 1) ^ -(long long) (u & 1);
+}
+
+//  readVarint
+//  Reads one operand, advancing past it; most are a single byte
+static inline unsigned long long readVarint( const unsigned char *&pc )
+{
+    unsigned long long value = *pc++;
+    if (value < 0x80)
+        return value;
+    value &= 0x7f;
+    for (int shift = 7; ; shift += 7)
+    {
+        unsigned char next = *pc++;
+        value |= (unsigned long long) (next & 0x7f) << shift;
+        if (next < 0x80)
+            return value;
+    }
+}
+
+Bytecode::Bytecode( int values, int calls )
+{
+    start = -1;
+    stackDepth = mostDepth = mainDepth = 0;
+    stackSize = values;
+    callLimit = calls;
+}
+
+void Bytecode::emitVarint( unsigned long long value )
+{
+    while (value >= 0x80)
+    {
+        code.push_back( (unsigned char) (value | 0x80) );
+        value >>= 7;
+    }
+    code.push_back( (unsigned char) value );
+}
+
+void Bytecode::constant( const Integer& value )
+{
+#if defined(VALUE_BIGNUM)
+    if (!value.isSmall())
+    {
+        op( OP_BIG, bigConstants.size() );
+        bigConstants.push_back( value );
+        return;
+    }
+    long long n = value.toLongLong();
+#else
+    long long n = value;
+#endif
+    code.push_back( OP_CONST );
+    emitVarint( zigzag( n ) );
+    stackDepth += stackEffect[OP_CONST];
+    mostDepth = max( mostDepth, stackDepth );
+}
+
+void Bytecode::op( Opcode op )
+{
+    code.push_back( op );
+    stackDepth += stackEffect[op];
+    mostDepth = max( mostDepth, stackDepth );
+}
+
+void Bytecode::op( Opcode op, int operand )
+{
+    code.push_back( op );
+    emitVarint( operand );
+    stackDepth += stackEffect[op];
+    mostDepth = max( mostDepth, stackDepth );
+}
+
+//  The target is left as four bytes of zeros, still a valid varint,
+//  until land fills it in
+int Bytecode::jump( Opcode op )
+{
+    code.push_back( op );
+    int at = code.size();
+    code.push_back( 0x80 );
+    code.push_back( 0x80 );
+    code.push_back( 0x80 );
+    code.push_back( 0x00 );
+    stackDepth += stackEffect[op];
+    return at;
+}
+
+void Bytecode::land( int jump )
+{
+    unsigned int target = code.size();
+    for (int i = 0; i < 3; ++i)
+        code[jump + i] = (unsigned char) (((target >> (7 * i)) & 0x7f) | 0x80);
+    code[jump + 3] = (unsigned char) (target >> 21);
+}
+
+//  A function not yet defined is given a number now, which its
+//  definition will fill in (see addFunction)
+void Bytecode::call( FunDef* function, int argc )
+{
+    map<const FunDef*, int>::iterator known = numbers.find( function );
+    int number;
+    if (known != numbers.end())
+        number = known->second;
+    else
+    {
+        number = functions.size();
+        BytecodeFunction undefined = { function->name, -1, 0, 0, 0 };
+        functions.push_back( undefined );
+        numbers[function] = number;
+    }
+    code.push_back( OP_CALL );
+    emitVarint( number );
+    emitVarint( argc );
+    stackDepth += stackEffect[OP_CALL] - argc;
+    mostDepth = max( mostDepth, stackDepth );
+}
+
+//  begin, end
+//  Every piece of code is added in place of the halt that ended the
+//  program so far, and ends with a halt of its own
+void Bytecode::begin( int line )
+{
+    if (!code.empty())
+        code.pop_back();
+    lineStarts.push_back( make_pair( (int) code.size(), line ) );
+    stackDepth = mostDepth = 0;
+}
+
+void Bytecode::end()
+{
+    code.push_back( OP_HALT );
+}
+
+void Bytecode::addLine( const ExprNode& root, VarTree& vars, FunctionDef& funs, int line )
+{
+    begin( line );
+    if (start < 0)
+        start = code.size();
+    root.toBytecode( *this, vars, funs, false );
+    op( OP_PRINT );
+    mainDepth = max( mainDepth, mostDepth );
+    end();
+}
+
+//  A function that is defined again is given a new number, so that the
+//  calls made so far still run the code they did
+void Bytecode::addFunction( FunDef& function, FunctionDef& funs, int line )
+{
+    begin( line );
+    int skip = -1;
+    if (start >= 0)
+        skip = jump( OP_JUMP );
+
+    map<const FunDef*, int>::iterator known = numbers.find( &function );
+    int number;
+    if (known != numbers.end() && functions[known->second].entry < 0)
+        number = known->second;
+    else
+    {
+        number = functions.size();
+        functions.push_back( BytecodeFunction() );
+        functions[number].name = function.name;
+        numbers[&function] = number;
+    }
+    functions[number].entry = code.size();     // (before the body, which may call itself)
+
+    stackDepth = mostDepth = 0;
+    function.functionBody->toBytecode( *this, *function.locals, funs, true );
+    op( OP_RETURN );
+
+    BytecodeFunction &compiled = functions[number];
+    compiled.params = function.parameter.size();
+    compiled.locals = function.locals->size() - compiled.params;
+    compiled.depth = mostDepth;
+    if (skip >= 0)
+        land( skip );
+    end();
+}
+
+//  arithmetic
+//  Applies one arithmetic operator to two values.
+//  When compiled with -DCHECKED, a result that is not defined is
+//  reported along with the instruction, and taken to be 0.
+//  Parameters:
+//      op      (input char)            the operator, one of + - * / %
+//      a, b    (input Integer)         the operands
+//      at      (input pointer)         the instruction computing it
+inline Integer Bytecode::arithmetic( char op, const Integer &a, const Integer &b,
+        const unsigned char *at ) const
+{
+#if defined(CHECKED)
+    Integer result;
+    const char *problem = checkedArithmetic( op, a, b, result );
+    if (problem != NULL)
+    {
+        report( problem, at );
+        return 0;
+    }
+    return result;
+#else
+    (void) at;                  // only needed to report a problem
+    switch (op)
+    {
+    case '+':   return a + b;
+    case '-':   return a - b;
+    case '*':   return a * b;
+    case '/':   return a / b;
+    default:    return a % b;
+    }
+#endif
+}
+
+//  report
+//  Describes an error, with the instruction where it happened and the
+//  source line that instruction came from
+void Bytecode::report( const char *problem, const unsigned char *at ) const
+{
+    int offset = at - &code[0];
+    cout << "Error: " << problem << " at " << offset << ": ";
+    decode( at, cout );
+    int line = -1;
+    for (size_t i = 0; i < lineStarts.size() && lineStarts[i].first <= offset; ++i)
+        line = lineStarts[i].second;
+    if (line >= 0)
+        cout << " (line " << line + 1 << ")";
+    cout << endl;
+}
+
+//  The stack of values is one array.  A call's frame is the part of it
+//  starting at its first argument; only the return address and the
+//  caller's frame are kept apart, with the calls in progress.
+//  The value on top of the stack is held in top instead; so pushing
+//  a value first stores top in the array, and popping one loads it.
+//  There is always a top -- at first just a 0 no one will look at.
+bool Bytecode::run( int globals )
+{
+    if (start < 0)
+        return true;
+
+    globalValues.assign( globals + 1, 0 );
+    if (stack.size() < (size_t) (stackSize + mainDepth + 2))
+        stack.resize( stackSize + mainDepth + 2 );
+    if (frames.size() < (size_t) callLimit)
+        frames.resize( callLimit );
+    Integer *global = &globalValues[0],
+            *sp = &stack[0],            // first free place
+            *fp = sp,                   // the frame of the function running
+            *stackEnd = sp + stack.size();
+    int calls = 0;
+    const unsigned char *base = &code[0],
+                        *pc = base + start;
+    Integer top = 0;
+
+    for (;;)
+    {
+        switch (*pc++)
+        {
+        case OP_HALT:
+            return true;
+        case OP_CONST:
+            *sp++ = top;
+            top = (Integer) unzigzag( readVarint( pc ) );
+            break;
+        case OP_BIG:
+            *sp++ = top;
+            top = bigConstants[readVarint( pc )];
+            break;
+        case OP_LOAD:
+            *sp++ = top;
+            top = global[readVarint( pc )];
+            break;
+        case OP_STORE:
+            global[readVarint( pc )] = top;
+            break;
+        case OP_LOAD_LOCAL:
+            *sp++ = top;
+            top = fp[readVarint( pc )];
+            break;
+        case OP_STORE_LOCAL:
+            fp[readVarint( pc )] = top;
+            break;
+
+        case OP_ADD:    --sp;  top = arithmetic( '+', *sp, top, pc - 1 );  break;
+        case OP_SUB:    --sp;  top = arithmetic( '-', *sp, top, pc - 1 );  break;
+        case OP_MUL:    --sp;  top = arithmetic( '*', *sp, top, pc - 1 );  break;
+        case OP_DIV:    --sp;  top = arithmetic( '/', *sp, top, pc - 1 );  break;
+        case OP_MOD:    --sp;  top = arithmetic( '%', *sp, top, pc - 1 );  break;
+        case OP_LT:     --sp;  top = *sp < top;    break;
+        case OP_GT:     --sp;  top = *sp > top;    break;
+        case OP_LE:     --sp;  top = *sp <= top;   break;
+        case OP_GE:     --sp;  top = *sp >= top;   break;
+        case OP_EQ:     --sp;  top = *sp == top;   break;
+        case OP_NE:     --sp;  top = *sp != top;   break;
+
+        case OP_JUMP:
+            pc = base + readVarint( pc );
+            break;
+        case OP_JUMP_FALSE:
+        {
+            unsigned long long target = readVarint( pc );
+            bool taken = !top;
+            top = *--sp;
+            if (taken)
+                pc = base + target;
+            break;
+        }
+
+        //  Missing arguments are taken as 0, and extra ones dropped
+        case OP_CALL:
+        {
+            const unsigned char *at = pc - 1;
+            const BytecodeFunction &function = functions[readVarint( pc )];
+            int argc = readVarint( pc );
+            *sp++ = top;                        // every argument in the array
+            Integer *frame = sp - argc;
+            if (function.entry < 0)
+            {
+                report( "call to a function that is not defined", at );
+                sp = frame;
+                top = 0;
+                break;
+            }
+            if (calls == callLimit
+                    || frame + function.params + function.locals + function.depth + 1 >= stackEnd)
+            {
+                report( "stack overflow", at );
+                return false;
+            }
+            for (sp = frame + argc; sp < frame + function.params; ++sp)
+                *sp = 0;
+            sp = frame + function.params;
+            for (int i = 0; i < function.locals; ++i)
+                *sp++ = 0;
+            frames[calls].returnTo = pc;
+            frames[calls].frame = fp;
+            ++calls;
+            fp = frame;
+            top = 0;
+            pc = base + function.entry;
+            break;
+        }
+        case OP_RETURN:                         // the result is already on top
+            --calls;
+            sp = fp;
+            fp = frames[calls].frame;
+            pc = frames[calls].returnTo;
+            break;
+        case OP_PRINT:
+            resultSink->put( top );
+            top = *--sp;
+            break;
+        default:
+            report( "bad instruction", pc - 1 );
+            return false;
+        }
+    }
+}
+
+//  decode
+//  Writes one instruction, without a newline
+//  Returns:    the instruction after it
+const unsigned char *Bytecode::decode( const unsigned char *pc, ostream& out ) const
+{
+    unsigned char op = *pc++;
+    if (op >= OP_COUNT)
+    {
+        out << "?" << (int) op;
+        return pc;
+    }
+    out << mnemonic[op];
+    switch (op)
+    {
+    case OP_CONST:
+        out << ' ' << unzigzag( readVarint( pc ) );
+        break;
+    case OP_BIG:
+        out << ' ' << bigConstants[readVarint( pc )];
+        break;
+    case OP_LOAD: case OP_STORE: case OP_LOAD_LOCAL: case OP_STORE_LOCAL:
+    case OP_JUMP: case OP_JUMP_FALSE:
+        out << ' ' << readVarint( pc );
+        break;
+    case OP_CALL:
+        out << ' ' << functions[readVarint( pc )].name;
+        out << ' ' << readVarint( pc );
+        break;
+    }
+    return pc;
+}
+
+//  Each instruction is listed with its offset, as the machine's are
+//  with their index
+void Bytecode::disassemble( ostream& out ) const
+{
+    const unsigned char *pc = code.empty() ? NULL : &code[0],
+                        *codeEnd = pc + code.size();
+    while (pc < codeEnd)
+    {
+        out << setw(2) << pc - &code[0] << ": ";
+        pc = decode( pc, out );
+        out << '\n';
+    }
+}
@@ -0,0 +1,139 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+// Bytecode Header File
+// A second target for the compiler, beside the machine of machine.h:
+// a stack machine whose program is a string of bytes, rather than an
+// array of Instruction objects each with registers of its own.
+// An expression tree maps onto it just as it maps onto postfix (see
+// Homework 4) -- the operands are pushed, and an operator replaces
+// the top two with its result -- so no registers are needed at all.
+//
+// Every instruction is a one-byte opcode, followed by any operands as
+// varints: seven bits to a byte, least significant first, with the top
+// bit set on every byte but the last.  A constant is zigzag-encoded,
+// so that a small negative one is short too; one too large for a long
+// long (under VALUE_BIGNUM) is kept in a table instead.  A jump target
+// is always written in four bytes (a varint with leading zeros), so
+// that it can be filled in once it is known.
+// So an ordinary instruction is one to three bytes long, where one of
+// the machine's takes an object of 24 bytes or more and a pointer.
+//
+// While it runs, the top of the stack is kept in a local variable, so
+// an operator touches memory only for its other operand.
+//
+// A function's code follows a jump around it, as on the machine.  Its
+// frame is the arguments the call left on the stack, followed by its
+// other local variables, at the offsets the compiler gave them.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+using namespace std;
+#include "value.h"
+#include "vartree.h"
+#include "funmap.h"
+
+class ExprNode;
+
+enum Opcode
+{
+    OP_HALT,            // end of the program
+    OP_CONST,           // n: push the constant n
+    OP_BIG,             // i: push constant i from the table
+    OP_LOAD,            // s: push the variable at stack location s
+    OP_STORE,           // s: store the top there, leaving it
+    OP_LOAD_LOCAL,      // s: push the variable at offset s in the frame
+    OP_STORE_LOCAL,     // s: store the top there, leaving it
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD,
+    OP_LT, OP_GT, OP_LE, OP_GE, OP_EQ, OP_NE,
+    OP_JUMP,            // t: continue at t
+    OP_JUMP_FALSE,      // t: pop the top, and if it is 0, continue at t
+    OP_CALL,            // f a: call function f, with a arguments on the stack
+    OP_RETURN,          // return the top from a function
+    OP_PRINT,           // pop the top, and send it to the resultSink
+    OP_COUNT
+};
+
+// What the machine needs to know about each function
+struct BytecodeFunction
+{
+    string name;
+    int entry;              // first instruction, or -1 if not yet defined
+    int params, locals;     // variables in the frame
+    int depth;              // most its code ever pushes onto the stack
+};
+
+// A call in progress
+struct BytecodeFrame
+{
+    const unsigned char *returnTo;
+    Integer *frame;         // the caller's
+};
+
+class Bytecode
+{
+    private:
+        vector<unsigned char> code;
+        vector<Integer> bigConstants;       // those that do not fit in a varint
+        vector<BytecodeFunction> functions;
+        map<const FunDef*, int> numbers;    // the entry in functions a call uses
+        vector< pair<int,int> > lineStarts; // where each source line's code begins
+        int start;                          // where the program begins, or -1
+        int stackDepth, mostDepth;          // of the code being generated
+        int mainDepth;                      // most any main line pushes
+        int stackSize, callLimit;
+        vector<Integer> globalValues;       // kept from one run to the next
+        vector<Integer> stack;
+        vector<BytecodeFrame> frames;
+
+        void emitVarint( unsigned long long );
+        void begin( int line );
+        void end();
+        Integer arithmetic( char op, const Integer &a, const Integer &b,
+                const unsigned char *at ) const;
+        const unsigned char *decode( const unsigned char *, ostream& ) const;
+        void report( const char *problem, const unsigned char *at ) const;
+
+        Bytecode( const Bytecode& );            // never copied
+        Bytecode& operator=( const Bytecode& );
+    public:
+        // room for values on the stack, and for calls in progress
+        Bytecode( int values = 1000000, int calls = 100000 );
+
+        // For the expression trees to generate their code with
+        void constant( const Integer& value );
+        void op( Opcode op );                   // one without operands
+        void op( Opcode op, int operand );
+        int jump( Opcode op );                  // returns the jump, to land
+        void land( int jump );                  // the jump comes here
+        void call( FunDef* function, int argc );
+        int depth() const { return stackDepth; }
+        void setDepth( int d ) { stackDepth = d; }
+
+        // addLine
+        // Adds the code for one line of the main program, which prints
+        // its value
+        // Parameters:
+        //     root (input ExprNode)        the line's (optimized) tree
+        //     vars (modified VarTree)      stack locations of the variables
+        //     funs (modified FunctionDef)  functions it may call
+        //     line (input integer)         source line, for error reports
+        void addLine( const ExprNode& root, VarTree& vars, FunctionDef& funs, int line );
+
+        // addFunction
+        // Adds the code for a function, which calls compiled from now
+        // on (and any made before it was defined) will use
+        void addFunction( FunDef& function, FunctionDef& funs, int line );
+
+        // run
+        // Runs the whole program, with that many global variables, all
+        // starting at 0
+        // Returns:    whether it ran to the end without an error
+        bool run( int globals );
+
+        int size() const { return code.size(); }   // in bytes
+        void disassemble( ostream& ) const;
+};
+
+#endif
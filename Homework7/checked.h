@@ -0,0 +1,94 @@
+#ifndef CHECKED_H
+#define CHECKED_H
+// Checked Arithmetic Header File
+// Compiling with -DCHECKED sends all arithmetic on values through
+// checkedArithmetic below, which notices a result too large for the
+// Integer type (see value.h), and division (or remainder) by zero --
+// where the plain operators would have undefined behavior, or crash.
+// The caller then reports the expression or instruction at fault and
+// carries on with 0.  (A BigInt always has room for a result, so for
+// it only division by zero is ever reported.)
+//
+// Without -DCHECKED the plain operators are used as always, and
+// nothing here costs anything at all.
+
+#include <limits>
+#include <stddef.h>
+using namespace std;
+#include "value.h"
+
+// addOverflows, subtractOverflows, multiplyOverflows
+// Compute a result, returning whether it did not fit
+#if defined(VALUE_BIGNUM)
+inline bool addOverflows( const Integer &a, const Integer &b, Integer &r )
+{
+    r = a + b;
+    return false;
+}
+inline bool subtractOverflows( const Integer &a, const Integer &b, Integer &r )
+{
+    r = a - b;
+    return false;
+}
+inline bool multiplyOverflows( const Integer &a, const Integer &b, Integer &r )
+{
+    r = a * b;
+    return false;
+}
+inline bool quotientOverflows( const Integer &, const Integer & )
+{
+    return false;
+}
+#else
+inline bool addOverflows( Integer a, Integer b, Integer &r )
+{
+    return __builtin_add_overflow( a, b, &r );
+}
+inline bool subtractOverflows( Integer a, Integer b, Integer &r )
+{
+    return __builtin_sub_overflow( a, b, &r );
+}
+inline bool multiplyOverflows( Integer a, Integer b, Integer &r )
+{
+    return __builtin_mul_overflow( a, b, &r );
+}
+// the one quotient that does not fit: the smallest value over -1
+inline bool quotientOverflows( Integer a, Integer b )
+{
+    return b == -1 && a == numeric_limits<Integer>::min();
+}
+#endif
+
+// checkedArithmetic
+// Applies one operator, noticing any result that is not defined
+// Parameters:
+//     oper   (input char)     one of + - * / %
+//     a, b   (input Integer)  the operands
+//     result (output Integer) the result, if there is one
+// Returns:
+//     a description of what went wrong, or NULL if nothing did
+inline const char *checkedArithmetic( char oper, const Integer &a, const Integer &b,
+        Integer &result )
+{
+    switch (oper)
+    {
+    case '+':
+        return addOverflows( a, b, result ) ? "overflow" : NULL;
+    case '-':
+        return subtractOverflows( a, b, result ) ? "overflow" : NULL;
+    case '*':
+        return multiplyOverflows( a, b, result ) ? "overflow" : NULL;
+    case '/':
+    case '%':
+        if (b == 0)
+            return "division by zero";
+        if (quotientOverflows( a, b ))
+            return "overflow";
+        result = (oper == '/') ? a / b : a % b;
+        return NULL;
+    default:
+        return "unknown operator";
+    }
+}
+
+#endif
@@ -1,8 +1,8 @@
 // Simple Expression Evaluation 
 // This program will evaluate simple arithmetic expressions
-// represented as a linked-list of tokens.  Keyboard input
-// will be accepted into a string, which will be converted
-// into that linked list.
+// represented as a stream of tokens.  Keyboard input
+// will be accepted into a string, from which a Lexer will
+// produce the tokens as the parser asks for them.
 //
 // If the first symbol in the input string is an operator,
 // then the value of the previous expression will be taken
@@ -21,116 +21,421 @@
 // A factor may be a number or a parenthesized sum expression.
 
 #include <iostream>
+#include <climits>
 #include "tokenlist.h"
+#include "lexer.h"
 #include "exprtree.h"
 #include "funmap.h"
 #include "machine.h"
 #include "compile.h"
+#include "dc.h"
+#include "bytecode.h"
+#include "checked.h"
+#include "timer.h"
+#include "alloctrack.h"
 
 using namespace std;
 
-ExprNode* conditionalToTree(ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* testToTree       (ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* assignmentToTree (ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* sumToTree        (ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* prodToTree       (ListIterator& infix, TokenList& list, FunctionDef& funs);
-ExprNode* factorToTree     (ListIterator& infix, TokenList& list, FunctionDef& funs);
-void      makeFunction     (ListIterator& infix, TokenList& list, FunctionDef& funs);
+ExprNode* conditionalToTree(Lexer& infix, FunctionDef& funs, NodeArena& arena);
+ExprNode* testToTree       (Lexer& infix, FunctionDef& funs, NodeArena& arena);
+ExprNode* assignmentToTree (Lexer& infix, FunctionDef& funs, NodeArena& arena);
+ExprNode* sumToTree        (Lexer& infix, FunctionDef& funs, NodeArena& arena);
+ExprNode* prodToTree       (Lexer& infix, FunctionDef& funs, NodeArena& arena);
+ExprNode* factorToTree     (Lexer& infix, FunctionDef& funs, NodeArena& arena);
+FunDef*   makeFunction     (Lexer& infix, FunctionDef& funs);
 bool isOperator(Token t);
-string tokenText(ListIterator& infix, TokenList& list);
+static void compileTokens(Lexer& lex, VarTree &vars, FunctionDef& funs, Instruction *prog[],
+        int& pBegin, int& pEnd, int line, CompileTimes* times, DcProgram* dc, Bytecode* bytecode,
+        unsigned long long start);
+
+static bool compileFunction(FunDef& function, FunctionDef& funs, Instruction *prog[],
+        int& pBegin, int& pEnd);
+static void fuseSequences(Instruction *prog[], int begin, int& end, FunctionDef& funs);
+
+const int INLINE_LIMIT = 16;        // most nodes in a body that is inlined
+
+bool optimizeTrees = true;
+bool superinstructions = true;
+int codeLimit = INT_MAX;
+int tempsNeeded = 0;
+
+// fits
+// Whether the code for a tree of so many nodes surely fits in the
+// program.  No node generates more than four instructions (a
+// conditional: its branch, its jump and two moves), and a line or
+// function needs at most three more around them.
+static bool fits(int nodes, int pEnd)
+{
+    return pEnd <= codeLimit - 3 && nodes <= (codeLimit - 3 - pEnd) / 4;
+}
+
+// reportTooLong
+// Says that a line was left out, for want of room for its code
+static void reportTooLong(int line)
+{
+    cout << "Error: program too long, no room for its code";
+    if (line >= 0)
+        cout << " (line " << line + 1 << ")";
+    cout << endl;
+}
 
-// Evaluate
-// Tokenizes the string, converts to post-fix order, and evaluates that
+// Compile
+// Converts the string to a tree, and generates code from that
+// Every instruction generated is marked with the given source line,
+// and the time spent in each phase is reported if times is not NULL.
 // Parameters:
 //     str (input char array) - string to evaluate
 // Pre-condition:  str must be a valid integer arithmetic expression including matching parentheses.
 void compile(const char str[], VarTree &vars, FunctionDef& funs, Instruction *prog[],
-        int& pBegin, int& pEnd)
+        int& pBegin, int& pEnd, int line, CompileTimes* times, DcProgram* dc, Bytecode* bytecode)
 {
-    TokenList list(str);
-    ListIterator iter = list.begin();
+    unsigned long long start = readCycles();
+    Lexer lex(str);
+    compileTokens(lex, vars, funs, prog, pBegin, pEnd, line, times, dc, bytecode, start);
+}
 
-    int tempCounter = 0;
+// Compile
+// As above, but reads the next line of a stream, a piece at a time,
+// so that the line itself is never held in memory all at once
+// Parameters:
+//     in (modified istream) - stream to read the line from
+void compile(istream& in, VarTree &vars, FunctionDef& funs, Instruction *prog[],
+        int& pBegin, int& pEnd, int line, CompileTimes* times, DcProgram* dc, Bytecode* bytecode)
+{
+    unsigned long long start = readCycles();
+    Lexer lex(in);
+    compileTokens(lex, vars, funs, prog, pBegin, pEnd, line, times, dc, bytecode, start);
+}
+
+// compileTokens
+// Parses the tokens from a lexer into a tree, and generates code from that
+// The parsers pull tokens from the lexer as they need them, so tokenizing
+// is done during parsing, and the time for it is counted with the parse.
+// dc code is generated from the same (optimized) tree as the instructions;
+// each expression's value is printed and then dropped.  So is bytecode.
+// Parameters:
+//     lex   (modified Lexer) - source of the tokens
+//     start (input integer)  - when the lexer was created
+// (and the rest as for compile)
+static void compileTokens(Lexer& lex, VarTree &vars, FunctionDef& funs, Instruction *prog[],
+        int& pBegin, int& pEnd, int line, CompileTimes* times, DcProgram* dc, Bytecode* bytecode,
+        unsigned long long start)
+{
+    static NodeArena lineArena;     // holds each tree until code is generated
+
+    int firstNew = pEnd;
+    unsigned long long tokenized = readCycles(),
+                       parsed;
 
-    if (tokenText(iter,list) == "deffn")
+    if (lex.tokenText() == "deffn")
     {
-        //cout << list << endl;
-        makeFunction(iter, list, funs);
-        //return 0;
+        FunDef* function = makeFunction(lex, funs);
+        parsed = readCycles();
+        ALLOC_SCOPE( ALLOC_CODEGEN );
+        if (!compileFunction(*function, funs, prog, pBegin, pEnd))
+            reportTooLong(line);
+        else
+        {
+            if (dc != NULL)
+            {
+                dc->startLine(line);
+                dc->code += makedcDefinition(*function, *dc) + "\n";
+            }
+            if (bytecode != NULL)
+                bytecode->addFunction(*function, funs, line);
+        }
     }
     else
     {
-        ExprNode* root = assignmentToTree(iter,list,funs);
+        ExprNode* root = assignmentToTree(lex,funs,lineArena);
+        parsed = readCycles();
+        if (optimizeTrees)
+            root = root->optimize(funs, NULL, lineArena);
 #ifdef DEBUG
         cout << *root << endl;
 #endif
         //return root->evaluate(vars, funs);
-        int tempCounter = 0;
-        int answerReg = root->toInstruction(prog, pEnd, tempCounter, vars);
-        pBegin = 0;
+        ALLOC_SCOPE( ALLOC_CODEGEN );
+        TreeSummary size;
+        root->summarize(size);
+        if (!fits(size.nodes, pEnd))
+            reportTooLong(line);
+        else
+        {
+            int tempCounter = 0;
+            if (pBegin < 0)
+                pBegin = pEnd;      // the main program begins here
+            int answerReg = root->toInstruction(prog, pEnd, tempCounter, vars, funs, false);
+            tempsNeeded = max(tempsNeeded, tempCounter);
+
+            prog[pEnd++] = new Print(answerReg);
+            if (dc != NULL)
+            {
+                dc->startLine(line);
+                dc->code += root->makedc(*dc) + "ps" + DC_DISCARD + "\n";
+            }
+            if (bytecode != NULL)
+                bytecode->addLine(*root, vars, funs, line);
+        }
+        lineArena.release();
+    }
+    if (superinstructions)
+        fuseSequences(prog, firstNew, pEnd, funs);
+
+    for (int i = firstNew; i < pEnd; ++i)
+        if (prog[i] != NULL)
+            prog[i]->setSourceLine(line);
 
-        prog[pEnd++] = new Print(answerReg);
+    if (times != NULL)
+    {
+        times->tokenize = tokenized - start;
+        times->parse    = parsed - tokenized;
+        times->codegen  = readCycles() - parsed;
     }
 
-    //cout << root->makedc() << endl
     //cout << *root << endl;
 }
 
-void makeFunction(ListIterator& infix, TokenList& list, FunctionDef& funs)
+// compileFunction
+// Generates the code for a function body, once, for every call to use
+// A call leaves the arguments at the top of the stack, where they
+// become the start of the function's frame (see machine.h); any other
+// variables the body assigns to are also kept in the frame, after them.
+// If the main program has already begun, it jumps around this code.
+// Any calls compiled before the function was are now given its entry.
+// The body is first optimized (see exprtree.h); if it then turns out
+// to be small, and neither calls itself nor assigns to anything,
+// later calls may simply use a copy of it instead.
+// Parameters:
+//     function (modified FunDef)  function to compile
+//     (and the rest as for compile)
+// Returns:    whether there was room for its code (if not, it is left
+//             undefined)
+static bool compileFunction(FunDef& function, FunctionDef& funs, Instruction *prog[],
+        int& pBegin, int& pEnd)
 {
-    infix.advance(); //advance past deffn
+    function.inlinable = false;
+    if (optimizeTrees)
+        function.functionBody = function.functionBody->optimize(funs, NULL, *function.nodes);
+    TreeSummary body;
+    function.functionBody->summarize(body);
+    if (!fits(body.nodes, pEnd))
+        return false;
+    if (optimizeTrees)
+        function.inlinable = body.nodes <= INLINE_LIMIT && !body.assigns
+                && body.calls.count(function.name) == 0;
+
+    int skip = -1;
+    if (pBegin >= 0)
+        skip = pEnd++;          // filled in with a jump below
+
+    int params = function.parameter.size();
+
+    int enter = pEnd++;         // filled in once the frame size is known
+    function.entry = enter;     // (before the body, which may call itself)
+    for (size_t i = 0; i < function.unresolved.size(); ++i)
+        static_cast<Call*>(prog[function.unresolved[i]])->setEntry(enter, params);
+    function.unresolved.clear();
+    int tempCounter = 0;
+    int answerReg = function.functionBody->toInstruction(prog, pEnd, tempCounter,
+            *function.locals, funs, true);
+    tempsNeeded = max(tempsNeeded, tempCounter);
+
+    int frameSize = function.locals->size();
+    prog[enter] = new Enter(params, frameSize - params);
+    prog[pEnd++] = new Return(answerReg, frameSize);
+    if (skip >= 0)
+        prog[skip] = new Jump(pEnd);
+    return true;
+}
 
-    string name = tokenText(infix, list);
-    funs[name] = FunDef();
+// fuseAddImm
+// Recognizes  VarLoad Ta;  Val Tb;  Add Tc = Ta + Tb;  VarAssign Tc
+// (or with the Val first, or with Subtract and the Val second)
+// Parameters:
+//     code (input Inst array) - four instructions
+// Returns:    the superinstruction doing their work, or NULL
+static Instruction* fuseAddImm(Instruction *code[])
+{
+    if (code[3] == NULL || code[3]->opcode() != "VarAssign")
+        return NULL;            // as most often, and quickly seen
+    Compute *sum = dynamic_cast<Compute*>(code[2]);
+    VarAssign *store = dynamic_cast<VarAssign*>(code[3]);
+    if (sum == NULL || store == NULL || store->temp() != sum->temp()
+            || (sum->operation() != "+" && sum->operation() != "-"))
+        return NULL;
+    bool constantFirst = sum->operation() == "+" && dynamic_cast<Val*>(code[0]) != NULL;
+    VarLoad *load = dynamic_cast<VarLoad*>(code[constantFirst ? 1 : 0]);
+    Val *constant = dynamic_cast<Val*>(code[constantFirst ? 0 : 1]);
+    if (load == NULL || constant == NULL)
+        return NULL;
+    int loadReg = constantFirst ? sum->right() : sum->left(),
+        constantReg = constantFirst ? sum->left() : sum->right();
+    if (load->temp() != loadReg || constant->temp() != constantReg)
+        return NULL;
+
+    Integer imm = constant->value();
+    if (sum->operation() == "-" && subtractOverflows(0, constant->value(), imm))
+        return NULL;        // the one constant that cannot be negated
+    return new AddImmToStack(sum->temp(), load->location(), imm, store->location());
+}
 
-    FunDef* function = &funs[name]; //to avoid multiple lookups in this function body
+// fuseComputeStackStack
+// Recognizes  VarLoad Ta;  VarLoad Tb;  Tc = Ta op Tb
+// Parameters:
+//     code (input Inst array) - three instructions
+// Returns:    the superinstruction doing their work, or NULL
+static Instruction* fuseComputeStackStack(Instruction *code[])
+{
+    if (code[1] == NULL || code[1]->opcode() != "VarLoad")
+        return NULL;
+    VarLoad *first = dynamic_cast<VarLoad*>(code[0]),
+            *second = dynamic_cast<VarLoad*>(code[1]);
+    Compute *compute = dynamic_cast<Compute*>(code[2]);
+    if (first == NULL || second == NULL || compute == NULL
+            || compute->left() != first->temp() || compute->right() != second->temp())
+        return NULL;
+    return new ComputeStackStack(compute->temp(), first->location(),
+            second->location(), compute->operation());
+}
 
-    function->name = name;
+// fuseSequences
+// Replaces the common sequences of newly generated instructions with
+// superinstructions (see machine.h), and closes up the gaps left.
+// A sequence is not fused if anything may branch into its middle.
+// Every branch target within the new code, and every function entry
+// and unresolved call there, is moved along with its instruction.
+// Parameters:
+//     prog  (modified Inst array)   program code
+//     begin (input integer)         first instruction just generated
+//     end   (modified integer)      first unused spot, before and after
+//     funs  (modified FunctionDef)  functions, whose entries and
+//                                   unresolved calls may move
+static void fuseSequences(Instruction *prog[], int begin, int& end, FunctionDef& funs)
+{
+    static vector<bool> target;     // kept from line to line, with their room
+    static vector<int> moved;
+    target.assign(end - begin + 1, false);
+    for (int i = begin; i < end; ++i)
+    {
+        int *to = prog[i] != NULL ? prog[i]->branchTarget() : NULL;
+        if (to != NULL && *to >= begin && *to <= end)
+            target[*to - begin] = true;
+    }
+
+    moved.resize(end - begin + 1);
+    int out = begin;
+    for (int i = begin; i < end; )
+    {
+        Instruction *fused = NULL;
+        int length = 0;
+        // every sequence begins with a VarLoad, or a Val (which are
+        // recognized by name, much faster than by a failed cast)
+        string kind = prog[i] != NULL ? prog[i]->opcode() : "";
+        bool loads = kind == "VarLoad";
+        bool starts = loads || kind == "Val";
+        if (starts && i + 4 <= end && !target[i+1 - begin] && !target[i+2 - begin] && !target[i+3 - begin])
+        {
+            fused = fuseAddImm(prog + i);
+            length = 4;
+        }
+        if (fused == NULL && loads && i + 3 <= end && !target[i+1 - begin] && !target[i+2 - begin])
+        {
+            fused = fuseComputeStackStack(prog + i);
+            length = 3;
+        }
+
+        if (fused == NULL)
+        {
+            moved[i - begin] = out;
+            prog[out++] = prog[i++];
+            continue;
+        }
+        for (int j = i; j < i + length; ++j)
+        {
+            moved[j - begin] = out;
+            delete prog[j];
+        }
+        prog[out++] = fused;
+        i += length;
+    }
+    if (out == end)
+        return;                 // nothing was fused, so nothing moved
+    moved[end - begin] = out;
+
+    for (int i = begin; i < out; ++i)
+    {
+        int *to = prog[i] != NULL ? prog[i]->branchTarget() : NULL;
+        if (to != NULL && *to >= begin && *to <= end)
+            *to = moved[*to - begin];
+    }
+    for (FunctionDef::iterator f = funs.begin(); f != funs.end(); ++f)
+    {
+        if (f->second.entry >= begin && f->second.entry <= end)
+            f->second.entry = moved[f->second.entry - begin];
+        for (size_t i = 0; i < f->second.unresolved.size(); ++i)
+            if (f->second.unresolved[i] >= begin)
+                f->second.unresolved[i] = moved[f->second.unresolved[i] - begin];
+    }
+    end = out;
+}
+
+FunDef* makeFunction(Lexer& infix, FunctionDef& funs)
+{
+    ALLOC_SCOPE( ALLOC_PARSER );
+    infix.advance(); //advance past deffn
+
+    string name = infix.tokenText();
+    FunDef* function = bindFunction(funs, name); //the same FunDef any earlier calls refer to
+
+    function->entry = -1;
+    function->inlinable = false;
     infix.advance(); //advance past function name
     infix.advance(); //advance past '('
 
+    delete function->locals;        // any earlier definition is replaced
     function->locals = new VarTree();
+    function->parameter.clear();
 
-    int paramcount = 0;
-    while (tokenText(infix, list) != ")")
+    while (infix.tokenText() != ")")
     {
-        string paramname = tokenText(infix, list);
-        function->parameter[paramcount] = paramname;
-        function->locals->assign(paramname, 0);
-        ++paramcount;
+        string paramname = infix.tokenText();
+        function->locals->assign(paramname, (int) function->parameter.size());  //its offset in the frame
+        function->parameter.push_back(paramname);
         infix.advance();
 
-        if (tokenText(infix, list) == ",")
+        if (infix.tokenText() == ",")
             infix.advance();
 
     } //we are now on a ")"
     infix.advance(); //so advance past ")"
 
-    for (int i = paramcount; i < 10; ++i)
-        function->parameter[i] = "";
-
-    function->functionBody = assignmentToTree(infix,list,funs);
+    delete function->nodes;         // along with its body; no other tree shares
+    function->nodes = new NodeArena(1024);      // its nodes (see optimize)
+    function->functionBody = assignmentToTree(infix,funs,*function->nodes);
 
 #ifdef DEBUG
     cout << "Function:" << endl;
     cout << "    Name: " << function->name << endl;
-    for (int i = 0; i < 10 && function->parameter[i] != ""; ++i)
+    for (size_t i = 0; i < function->parameter.size(); ++i)
         cout << "    Parameter " << i << ": " << function->parameter[i] << endl;
     cout << "    VarTree: " << function->locals << endl;
     cout << "    VarTree: " << *function->locals << endl;
     cout << "    ExprNode: " << function->functionBody << endl;
     cout << "    ExprNode: " << *function->functionBody << endl;
 #endif
+    return function;
 }
 
 // assignmentToTree
 // Converts an infix assignment expression into a tree
 // Parameters:
-//     infix    (input Token list iterator)  - expression to convert
+//     infix    (modified Lexer) - expression to convert
 // Returns:
 //     root node of the tree representing the assignment
-ExprNode* assignmentToTree(ListIterator& infix, TokenList& list, FunctionDef& funs)
+ExprNode* assignmentToTree(Lexer& infix, FunctionDef& funs, NodeArena& arena)
 {
+    ALLOC_SCOPE( ALLOC_PARSER );
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
             * root = NULL;
@@ -139,22 +444,22 @@ ExprNode* assignmentToTree(ListIterator& infix, TokenList& list, FunctionDef& fu
     if (infix.tokenChar() == '-')    // if negative - This would count as improper formatting but I'll leave this in for the sake of keeping it from crashing
     {
         infix.advance();
-        Operation* negation = new Operation(conditionalToTree(infix,list,funs),"*",new Value(-1));
+        Operation* negation = new (arena) Operation(conditionalToTree(infix,funs,arena),"*",new (arena) Value(-1));
         lhs = static_cast<ExprNode *>(negation);
     }
     else
-        lhs = conditionalToTree(infix,list,funs);
+        lhs = conditionalToTree(infix,funs,arena);
 
-    oper = tokenText(infix,list);
+    oper = infix.tokenText();
     while (oper == "=")
     {
         infix.advance();
 
-        rhs = assignmentToTree(infix,list,funs); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = assignmentToTree(infix,funs,arena); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //Doesn't actually apply here, but for consistency with other functions
 
-        oper = tokenText(infix,list);
+        oper = infix.tokenText();
     }
 
     if (root == NULL)
@@ -166,10 +471,10 @@ ExprNode* assignmentToTree(ListIterator& infix, TokenList& list, FunctionDef& fu
 // conditionalToTree
 // Converts an infix conditional expression into a tree
 // Parameters:
-//     infix    (input Token list iterator)  - expression to convert
+//     infix    (modified Lexer) - expression to convert
 // Returns:
 //     root node of the tree representing the conditional
-ExprNode* conditionalToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* conditionalToTree(Lexer& infix, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* test      = NULL,
             * truecase  = NULL,
@@ -180,25 +485,25 @@ ExprNode* conditionalToTree(ListIterator &infix, TokenList& list, FunctionDef& f
     if (infix.tokenChar() == '-') //Would be improper for this to be true, but I'll leave it for stability
     {
         infix.advance();
-        Operation* negation = new Operation(testToTree(infix,list,funs),"*",new Value(-1));
+        Operation* negation = new (arena) Operation(testToTree(infix,funs,arena),"*",new (arena) Value(-1));
         test = static_cast<ExprNode *>(negation);
     }
     else
-        test = testToTree(infix,list,funs);
+        test = testToTree(infix,funs,arena);
 
-    oper = tokenText(infix,list);
+    oper = infix.tokenText();
     while (oper == "?")
     {
         infix.advance();
-        truecase = testToTree(infix,list,funs);
+        truecase = testToTree(infix,funs,arena);
 
         infix.advance(); //Move past assumed ":"
-        falsecase = testToTree(infix,list,funs);
+        falsecase = testToTree(infix,funs,arena);
 
-        root = static_cast<ExprNode *>(new Conditional(test, truecase, falsecase));
+        root = static_cast<ExprNode *>(new (arena) Conditional(test, truecase, falsecase));
         test = root; //return of a coditional could be test for another. i mean, there should be parentheses, but hey, supporting it isn't hard
 
-        oper = tokenText(infix,list);
+        oper = infix.tokenText();
     }
 
     if (root == NULL)
@@ -210,10 +515,10 @@ ExprNode* conditionalToTree(ListIterator &infix, TokenList& list, FunctionDef& f
 // testToTree
 // Converts an infix test expression into a tree
 // Parameters:
-//     infix    (input Token list iterator)  - expression to convert
+//     infix    (modified Lexer) - expression to convert
 // Returns:
 //     root node of the tree representing the test
-ExprNode* testToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* testToTree(Lexer& infix, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -223,22 +528,22 @@ ExprNode* testToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
     if (infix.tokenChar() == '-')
     {
         infix.advance();
-        Operation* negation = new Operation(sumToTree(infix,list,funs),"*",new Value(-1));
+        Operation* negation = new (arena) Operation(sumToTree(infix,funs,arena),"*",new (arena) Value(-1));
         lhs = static_cast<ExprNode *>(negation);
     }
     else
-        lhs = sumToTree(infix,list,funs);
+        lhs = sumToTree(infix,funs,arena);
 
-    oper = tokenText(infix,list);
+    oper = infix.tokenText();
     while (oper == ">" || oper == "<" || oper == ">=" || oper == "<=" || oper == "==" || oper == "!=")
     {
         infix.advance();
 
-        rhs = sumToTree(infix,list,funs); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = sumToTree(infix,funs,arena); // Assignment MUST evaluate right to left, or else we try to assign to an r-value. This accounts for that.
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //Doesn't actually apply here, but for consistency with other functions
 
-        oper = tokenText(infix,list);
+        oper = infix.tokenText();
     }
 
     if (root == NULL)
@@ -251,10 +556,10 @@ ExprNode* testToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
 // sumToTree
 // Converts an infix sum expression into a tree
 // Parameters:
-//     infix  (input Token list iterator) - expression to convert
+//     infix  (modified Lexer) - expression to convert
 // Returns:
 //     root node of the tree representing the sum
-ExprNode* sumToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* sumToTree(Lexer& infix, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -264,22 +569,22 @@ ExprNode* sumToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
     if (infix.tokenChar() == '-')
     {
         infix.advance();
-        Operation* negation = new Operation(prodToTree(infix,list,funs),"*",new Value(-1));
+        Operation* negation = new (arena) Operation(prodToTree(infix,funs,arena),"*",new (arena) Value(-1));
         lhs = static_cast<ExprNode *>(negation);
     }
     else
-        lhs = prodToTree(infix,list,funs);
+        lhs = prodToTree(infix,funs,arena);
 
-    oper = tokenText(infix,list);
+    oper = infix.tokenText();
     while (oper == "+" || oper == "-")
     {
         infix.advance();
 
-        rhs = prodToTree(infix,list,funs);
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = prodToTree(infix,funs,arena);
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //If we have multiple sums, the first sum becomes the left hand side of the first. This accounds for that.
 
-        oper = tokenText(infix,list);
+        oper = infix.tokenText();
     }
 
     if (root == NULL)
@@ -291,10 +596,10 @@ ExprNode* sumToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
 // prodToTree
 // Translates an infix product expression to a tree
 // Parameters:
-//     infix  (input Token list iterator) - expression to convert'
+//     infix  (modified Lexer) - expression to convert'
 // Returns:
 //     root node of the tree representing the sum
-ExprNode* prodToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* prodToTree(Lexer& infix, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* lhs  = NULL,
             * rhs  = NULL,
@@ -302,18 +607,18 @@ ExprNode* prodToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
 
     string oper;
 
-    lhs = factorToTree(infix,list,funs);
+    lhs = factorToTree(infix,funs,arena);
 
-    oper = tokenText(infix,list);
+    oper = infix.tokenText();
     while (oper == "*" || oper == "/" || oper == "%")
     {
         infix.advance();
 
-        rhs = factorToTree(infix,list,funs);
-        root = static_cast<ExprNode *>(new Operation(lhs, oper, rhs));
+        rhs = factorToTree(infix,funs,arena);
+        root = static_cast<ExprNode *>(new (arena) Operation(lhs, oper, rhs));
         lhs = root; //See this line in previous function for explaination of this line
 
-        oper = tokenText(infix,list);
+        oper = infix.tokenText();
     }
 
     if (root == NULL)
@@ -326,58 +631,59 @@ ExprNode* prodToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
 // Translates a factor from infix to a tree
 // A factor may either be a number or parenthesized expression.
 // Parameters:
-//     infix  (input Token List iterator) - expression to convert
+//     infix  (modified Lexer) - expression to convert
 // Returns:
 //     root node of the tree representing the factor
-ExprNode* factorToTree(ListIterator &infix, TokenList& list, FunctionDef& funs)
+ExprNode* factorToTree(Lexer& infix, FunctionDef& funs, NodeArena& arena)
 {
     ExprNode* output = NULL;
 
-    if (infix != list.end())
+    if (!infix.done())
     {
         if (!isOperator(infix.token()))
         {
             if (infix.currentIsInteger())
             {
-                output = static_cast<ExprNode *>(new Value(infix.integerValue()));
+                output = static_cast<ExprNode *>(new (arena) Value(infix.integerValue()));
+                infix.advance();
             }
-            else if (funs.find(tokenText(infix, list)) != funs.end()) // function call
+            else
             {
-                string name = tokenText(infix, list);
-                infix.advance(); //now on '('
-                infix.advance(); //now past '('
+                string name = infix.tokenText();
+                infix.advance(); //now on '(' if this is a function call
 
-                ExprNode* params[10];
-                for (int i = 0; i < 10; ++i)
+                if (infix.tokenText() == "(") // function call, perhaps to one not yet defined (see funmap.h)
                 {
-                    if (tokenText(infix, list) != ")")
+                    FunDef* function = bindFunction(funs, name);
+                    infix.advance(); //now past '('
+
+                    vector<ExprNode*> params;
+                    while (infix.tokenText() != ")" && !infix.done())
                     {
-                        params[i] = assignmentToTree(infix, list, funs); //now on either ',' or ')'
-                        if (tokenText(infix, list) == ",")
+                        params.push_back(assignmentToTree(infix, funs, arena)); //now on either ',' or ')'
+                        if (infix.tokenText() == ",")
                             infix.advance();
                         //now on either next param or ')'
-                    }
-                    else
-                        params[i] = NULL;
-                } //now on ')', which is handled by infix.advance() later
+                    } //now on ')'
 
-                output = static_cast<ExprNode *>(new Function(name, params));
-            }
-            else
-            {
-                output = static_cast<ExprNode *>(new Variable(infix.token().tokenText()));
+                    output = static_cast<ExprNode *>(new (arena) Function(function, params, arena));
+                    infix.advance(); //past ')'
+                }
+                else
+                {
+                    output = static_cast<ExprNode *>(new (arena) Variable(name));
+                }
             }
-            infix.advance();
         }
         else if (infix.tokenChar() == '-')
         {
             infix.advance();
-            output = static_cast<ExprNode *>(new Operation(factorToTree(infix,list,funs),"*",new Value(-1)));
+            output = static_cast<ExprNode *>(new (arena) Operation(factorToTree(infix,funs,arena),"*",new (arena) Value(-1)));
         }
         else
         {
             infix.advance();        // go past assumed (
-            output = assignmentToTree(infix, list, funs);
+            output = assignmentToTree(infix, funs, arena);
             infix.advance();        // go past assumed )
         }
     }
@@ -403,10 +709,3 @@ bool isOperator(Token t)
             text == "!=" || text == ",");
 }
 
-string tokenText(ListIterator& infix, TokenList& list)
-{
-    if (infix != list.end())
-        return infix.token().tokenText();
-    else
-        return "";
-}
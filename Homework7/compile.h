@@ -20,6 +20,37 @@
 #include "funmap.h"
 #include "machine.h"
 
+class Bytecode;
+class DcProgram;
+
+// Ticks spent in each phase of compiling one line of source
+// (see timer.h for what a tick is)
+struct CompileTimes
+{
+    unsigned long long tokenize;	// starting the lexer (the rest of
+					// tokenizing is counted in parse)
+    unsigned long long parse;		// building the expression tree
+    unsigned long long codegen;		// generating instructions
+};
+
+// Whether each tree is optimized before code is generated from it
+// (small functions inlined, and constants folded), as it is by default
+extern bool optimizeTrees;
+
+// Whether common sequences of instructions are fused into the
+// superinstructions of machine.h after code is generated, as they are
+// by default
+extern bool superinstructions;
+
+// How many instructions the program array given to compile has room
+// for; a line whose code might not fit is reported and left out.
+// Unless it is set, the array is taken to be large enough.
+extern int codeLimit;
+
+// The most temporary registers the code of any one line or function
+// compiled so far uses; the machine must have at least this many
+extern int tempsNeeded;
+
 // Compile
 // Compile the given expression into a machine code, with 
 // the given variables defined
@@ -31,7 +62,26 @@
 //	prog	(modified Inst array)	program code being generated
 //	pBegin	(output integer)	first instruction not in a function
 //	pEnd	(output integer)	program end (first unused spot)
+//	line	(input integer)		source line number, recorded in
+//					every instruction generated
+//	times	(output CompileTimes)	time spent in each phase, if not NULL
+//	dc	(modified DcProgram)	if not NULL, the same line as dc code
+//					(see dc.h) is added to the end of it
+//	bytecode (modified Bytecode)	if not NULL, the same line is also
+//					compiled to bytecode (see bytecode.h)
 void compile( const char expr[], VarTree &vars, FunctionDef &funs,
-	Instruction *prog[], int &pBegin, int &pEnd );
+	Instruction *prog[], int &pBegin, int &pEnd,
+	int line = -1, CompileTimes *times = NULL, DcProgram *dc = NULL,
+	Bytecode *bytecode = NULL );
+
+// Compile
+// As above, but reading the expression from the next line of a
+// stream, a piece at a time, rather than from a string
+// Parameters:
+//	in	(modified istream)	stream to read one line from
+void compile( istream &in, VarTree &vars, FunctionDef &funs,
+	Instruction *prog[], int &pBegin, int &pEnd,
+	int line = -1, CompileTimes *times = NULL, DcProgram *dc = NULL,
+	Bytecode *bytecode = NULL );
 
 #endif
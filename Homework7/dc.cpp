@@ -0,0 +1,417 @@
+// dc Interpreter Implementation File
+// Each character of the program is a command, looked at just once as
+// it is reached.  Running a macro runs its text in the same way, by a
+// recursive call -- the only thing that ever leaves a level of code.
+//
+// Values saved with S are kept in one fixed array, where each one
+// records the value it covered (the one L will bring back); places
+// no longer in use are chained together to be used again.
+
+#include <iostream>
+#include <map>
+using namespace std;
+
+#include "dc.h"
+#include "sink.h"
+#include "checked.h"
+
+const int MAX_NESTING = 10000;      // most macros running at once
+
+// the registers makedc chooses among first, in order of preference,
+// before any other byte (never a bracket, or one set aside in dc.h)
+static const char REGISTER_CHOICES[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789@$&^`{}|~:?'\"";
+
+string dcPrelude()
+{
+    return string("[r]s") + DC_SWAP + "[s" + DC_DISCARD + "1]s" + DC_TRUE + "\n";
+}
+
+DcProgram::DcProgram()
+{
+    for (int r = 0; r < 256; ++r)
+        used[r] = false;
+    used[(unsigned char) '['] = used[(unsigned char) ']'] = true;
+    used[(unsigned char) DC_DISCARD] = true;
+    used[(unsigned char) DC_SWAP] = true;
+    used[(unsigned char) DC_TRUE] = true;
+    exhausted = false;
+}
+
+char DcProgram::registerFor( const string& name, bool function )
+{
+    string key = function ? name + "()" : name;     // functions apart from variables
+    map<string, char>::iterator known = chosen.find(key);
+    if (known != chosen.end())
+        return known->second;
+
+    int reg = (unsigned char) name[0];
+    for (const char *c = REGISTER_CHOICES; *c != '\0' && used[reg]; ++c)
+        reg = (unsigned char) *c;
+    for (int r = 0; r < 256 && used[reg]; ++r)
+        reg = r;
+    if (used[reg])
+    {
+        if (!exhausted)
+            cout << "Error: no dc register left for " << name << endl;
+        exhausted = true;
+        return DC_DISCARD;
+    }
+
+    used[reg] = true;
+    chosen[key] = (char) reg;
+    return (char) reg;
+}
+
+int DcProgram::lineAt( int offset ) const
+{
+    int line = -1;
+    for (size_t i = 0; i < lineStarts.size() && lineStarts[i].first <= offset; ++i)
+        line = lineStarts[i].second;
+    return line;
+}
+
+// DcMachine constructor
+// Parameters:
+//     stackSize  (input integer)  room on the stack
+//     savedSize  (input integer)  room for values saved with S
+DcMachine::DcMachine( int stackSize, int savedSize )
+{
+    capacity = stackSize;
+    stack = new DcValue[capacity];
+    savedCapacity = savedSize;
+    saved = new DcValue[savedCapacity];
+    savedNext = new int[savedCapacity];
+    source = NULL;
+    clear();
+}
+
+DcMachine::~DcMachine()
+{
+    delete [] stack;
+    delete [] saved;
+    delete [] savedNext;
+}
+
+void DcMachine::clear()
+{
+    DcValue zero;
+    zero.number = 0;
+    zero.text = zero.textEnd = NULL;
+
+    depth = 0;
+    nesting = 0;
+    for (int r = 0; r < 256; ++r)
+    {
+        registers[r] = zero;
+        savedTop[r] = -1;
+    }
+    for (int i = 0; i < savedCapacity; ++i)
+        savedNext[i] = i + 1 < savedCapacity ? i + 1 : -1;
+    savedFree = savedCapacity > 0 ? 0 : -1;
+}
+
+Integer DcMachine::top() const
+{
+    if (depth == 0 || stack[depth-1].text != NULL)
+        return 0;
+    return stack[depth-1].number;
+}
+
+bool DcMachine::run( const char *program, const char *end )
+{
+    nesting = 0;
+    return execute( program, end );
+}
+
+bool DcMachine::run( const DcProgram& program )
+{
+    prelude = dcPrelude();
+    if (!run( prelude ))
+        return false;
+    source = &program;
+    bool ok = run( program.code );
+    source = NULL;
+    return ok;
+}
+
+//  showLine
+//  Follows an error message with the source line of the code where
+//  it happened, when that is known
+//  Parameters:
+//      at      (input char pointer)    the command in error
+void DcMachine::showLine( const char *at ) const
+{
+    if (source == NULL)
+        return;
+    const char *text = source->code.data();
+    if (at < text || at >= text + source->code.size())
+        return;
+    int line = source->lineAt( at - text );
+    if (line >= 0)
+        cout << " (line " << line + 1 << ")";
+}
+
+//  push
+//  Puts a value on top of the stack, if there is room
+bool DcMachine::push( const DcValue& v )
+{
+    if (depth == capacity)
+    {
+        cout << "dc: stack full" << endl;
+        return false;
+    }
+    stack[depth++] = v;
+    return true;
+}
+
+//  runRegister
+//  Runs the macro in a register; a number there is just pushed,
+//  as dc itself would do
+bool DcMachine::runRegister( char reg )
+{
+    const DcValue& macro = registers[(unsigned char) reg];
+    if (macro.text == NULL)
+        return push( macro );
+    return execute( macro.text, macro.textEnd );
+}
+
+//  execute
+//  Runs one piece of dc code, up to the end given
+//  Parameters:
+//      code, end   (input char pointers)   the code to run
+//  Returns:    whether there was no error
+bool DcMachine::execute( const char *code, const char *end )
+{
+    if (nesting == MAX_NESTING)
+    {
+        cout << "dc: macros nested too deeply" << endl;
+        return false;
+    }
+    ++nesting;
+
+    DcValue v;
+    v.text = v.textEnd = NULL;
+    bool ok = true;
+    const char *pc = code;
+    while (ok && pc < end)
+    {
+        char c = *pc++;
+        unsigned char reg = (pc < end) ? *pc : 0;
+        switch (c)
+        {
+        case ' ': case '\t': case '\n': case '\r':
+            break;
+
+        case '_':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            v.number = 0;
+            if (c != '_')
+                --pc;
+            while (pc < end && *pc >= '0' && *pc <= '9')
+                v.number = v.number * 10 + (*pc++ - '0');
+            if (c == '_')
+                v.number = -v.number;
+            v.text = NULL;
+            ok = push( v );
+            break;
+
+        case '+': case '-': case '*': case '/': case '%':
+            if (depth < 2)
+            {
+                cout << "dc: stack empty" << endl;
+                ok = false;
+            }
+            else if (stack[depth-1].text != NULL || stack[depth-2].text != NULL)
+            {
+                cout << "dc: non-numeric value" << endl;
+                ok = false;
+            }
+            else
+            {
+                Integer &a = stack[depth-2].number;
+                Integer b = stack[depth-1].number;
+                --depth;
+#if defined(CHECKED)
+                const char *problem = checkedArithmetic( c, a, b, a );
+                if (problem != NULL)
+                {
+                    cout << "Error: " << problem << " in dc " << c;
+                    showLine( pc - 1 );
+                    cout << endl;
+                    a = 0;
+                }
+#else
+                switch (c)
+                {
+                case '+':   a = a + b;  break;
+                case '-':   a = a - b;  break;
+                case '*':   a = a * b;  break;
+                case '/':   a = a / b;  break;
+                default:    a = a % b;  break;
+                }
+#endif
+            }
+            break;
+
+        case 'd':
+            if (depth == 0)
+            {
+                cout << "dc: stack empty" << endl;
+                ok = false;
+            }
+            else
+                ok = push( stack[depth-1] );
+            break;
+
+        case 'r':
+            if (depth < 2)
+            {
+                cout << "dc: stack empty" << endl;
+                ok = false;
+            }
+            else
+                swap( stack[depth-1], stack[depth-2] );
+            break;
+
+        case 'p':
+            if (depth == 0)
+            {
+                cout << "dc: stack empty" << endl;
+                ok = false;
+            }
+            else if (stack[depth-1].text != NULL)
+                cout << string( stack[depth-1].text, stack[depth-1].textEnd ) << '\n';
+            else
+                resultSink->put( stack[depth-1].number );
+            break;
+
+        case '[':
+        {
+            int open = 1;
+            const char *close = pc;
+            for ( ; close < end; ++close)
+                if (*close == '[')
+                    ++open;
+                else if (*close == ']' && --open == 0)
+                    break;
+            if (close == end)
+            {
+                cout << "dc: unterminated string" << endl;
+                ok = false;
+                break;
+            }
+            v.text = pc;
+            v.textEnd = close;
+            ok = push( v );
+            pc = close + 1;
+            break;
+        }
+
+        case 'x':
+            if (depth == 0)
+            {
+                cout << "dc: stack empty" << endl;
+                ok = false;
+            }
+            else if (stack[depth-1].text != NULL)
+            {
+                const DcValue &macro = stack[--depth];
+                ok = execute( macro.text, macro.textEnd );
+            }
+            break;
+
+        case 's': case 'l': case 'S': case 'L':
+        case '<': case '>': case '=': case '!':
+            if (pc == end || (c == '!' && pc + 1 == end))
+            {
+                cout << "dc: no register given for " << c << endl;
+                ok = false;
+            }
+            else if (c == 'l')
+            {
+                ok = push( registers[reg] );
+                ++pc;
+            }
+            else if (c == 'L')
+            {
+                int slot = savedTop[reg];
+                if (slot < 0)
+                {
+                    cout << "dc: stack register '" << reg << "' is empty" << endl;
+                    ok = false;
+                    break;
+                }
+                ok = push( registers[reg] );
+                registers[reg] = saved[slot];
+                savedTop[reg] = savedNext[slot];
+                savedNext[slot] = savedFree;
+                savedFree = slot;
+                ++pc;
+            }
+            else if (depth == 0 || (c != 's' && c != 'S' && depth < 2))
+            {
+                cout << "dc: stack empty" << endl;
+                ok = false;
+            }
+            else if (c == 's')
+            {
+                registers[reg] = stack[--depth];
+                ++pc;
+            }
+            else if (c == 'S')
+            {
+                int slot = savedFree;
+                if (slot < 0)
+                {
+                    cout << "dc: no room to save register '" << reg << "'" << endl;
+                    ok = false;
+                    break;
+                }
+                savedFree = savedNext[slot];
+                saved[slot] = registers[reg];
+                savedNext[slot] = savedTop[reg];
+                savedTop[reg] = slot;
+                registers[reg] = stack[--depth];
+                ++pc;
+            }
+            else
+            {
+                //  compare the top (b) with the one beneath it (a)
+                bool negate = (c == '!');
+                if (negate)
+                    c = *pc++;
+                reg = *pc++;
+                const DcValue &b = stack[depth-1], &a = stack[depth-2];
+                depth -= 2;
+                if (a.text != NULL || b.text != NULL)
+                {
+                    cout << "dc: non-numeric value" << endl;
+                    ok = false;
+                    break;
+                }
+                bool holds = (c == '<') ? b.number < a.number
+                           : (c == '>') ? a.number < b.number
+                           : (c == '=') ? a.number == b.number
+                           : false;
+                if (c != '<' && c != '>' && c != '=')
+                {
+                    cout << "dc: '!" << c << "' is not supported" << endl;
+                    ok = false;
+                }
+                else if (holds != negate)
+                    ok = runRegister( reg );
+            }
+            break;
+
+        default:
+            cout << "dc: '" << c << "' is not supported" << endl;
+            ok = false;
+            break;
+        }
+    }
+
+    --nesting;
+    return ok;
+}
@@ -0,0 +1,132 @@
+#ifndef DC_H
+#define DC_H
+// dc Interpreter Header File
+// Runs the programs that makedc produces (see exprtree.h) right here,
+// instead of handing them to the dc desk calculator.  Only the part
+// of dc's language that makedc uses is understood:
+//     123  _123       push a number (dc writes a negative one with _)
+//     + - * / %       arithmetic on the top two numbers
+//     d  r            duplicate the top, swap the top two
+//     sR  lR          pop into register R, push a copy of register R
+//     SR  LR          push onto register R's own stack, pop from it
+//     [text]          push a string (which may hold balanced brackets)
+//     x               run the string on top of the stack as a macro
+//     <R >R =R        pop two numbers, and run the macro in register R
+//     !<R !>R !=R         if the top one is less, greater, equal
+//                         (or with !, not so)
+//     p               print the top of the stack (a number goes to
+//                     the resultSink, just as from the machine)
+// Blanks and newlines are ignored.
+//
+// The program is run straight from its text; nothing is translated.
+// A string on the stack or in a register refers to its place in that
+// text, so the text must be kept as long as the machine is in use.
+// Every register R is any one byte but a bracket, and is simply an
+// entry in an array; the stack, and the values saved with S, have
+// fixed room.
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+using namespace std;
+#include "value.h"
+
+// Registers makedc sets aside for itself (see dcPrelude)
+const char DC_DISCARD = '.';        // holds whatever is thrown away
+const char DC_SWAP    = ',';        // a macro that swaps the top two
+const char DC_TRUE    = ';';        // a macro replacing the top with 1
+
+// dcPrelude
+// The dc code that must run before any that makedc produces,
+// to define the macros in the registers set aside above
+string dcPrelude();
+
+// The dc code for one program, as compile builds it up a line at a
+// time (see compile.h), and the register each name in it is kept in.
+// Each variable (or function's macro) gets a register of its own,
+// starting with its first letter if that is free.  There are only so
+// many; a name that finds none left is reported, and the program is
+// not complete, rather than two names quietly sharing a register.
+class DcProgram
+{
+    private:
+        map<string, char> chosen;
+        bool used[256];             // registers taken (or set aside)
+        bool exhausted;             // some name found none left
+        vector< pair<int,int> > lineStarts; // where each source line's code begins
+    public:
+        string code;                // to run after dcPrelude
+        DcProgram();
+
+        // notes that the code added next comes from the given source line
+        void startLine( int line )
+        {
+            lineStarts.push_back( make_pair( (int) code.size(), line ) );
+        }
+        // the source line of the code at an offset in code, or -1
+        int lineAt( int offset ) const;
+
+        // registerFor
+        // The register a variable (or a function's macro) is kept in
+        // Parameters:
+        //     name     (input string)  name of the variable or function
+        //     function (input bool)    whether it names a function
+        char registerFor( const string& name, bool function = false );
+
+        // whether every name was given a register of its own
+        bool complete() const { return !exhausted; }
+};
+
+// One value on the stack, or in a register:  a number, or a string
+struct DcValue
+{
+    Integer number;
+    const char *text;       // start of a string, or NULL for a number
+    const char *textEnd;    // and just past its end
+};
+
+class DcMachine
+{
+    private:
+        DcValue *stack;             // the stack, stack[0] at the bottom
+        int depth, capacity;
+        DcValue registers[256];
+        DcValue *saved;             // values pushed onto registers with S
+        int *savedNext;             // the value each of those covered
+        int savedTop[256];          // most recent for each register, or -1
+        int savedFree;              // first unused place in saved, or -1
+        int savedCapacity;
+        int nesting;                // macros now running
+        string prelude;             // run before a DcProgram's code
+        const DcProgram *source;    // the program being run, if known,
+                                    // to tell the line of an error
+
+        bool execute( const char *code, const char *end );
+        void showLine( const char *at ) const;
+        bool push( const DcValue& );
+        bool runRegister( char reg );
+
+        DcMachine( const DcMachine& );              // never copied
+        DcMachine& operator=( const DcMachine& );
+    public:
+        DcMachine( int stackSize = 10000, int savedSize = 100000 );
+        ~DcMachine();
+
+        // run
+        // Runs a program, leaving the registers and stack as it did
+        // Returns:    whether it ran to the end without an error
+        bool run( const char *program, const char *end );
+        bool run( const string& program )
+        {
+            return run( program.data(), program.data() + program.size() );
+        }
+        // the same, after dcPrelude, with errors given their source line
+        bool run( const DcProgram& program );
+
+        // the number on top of the stack, or 0 if there is none
+        Integer top() const;
+        void clear();               // empty the stack and every register
+};
+
+#endif
@@ -1,50 +1,179 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <string>
+#include <string.h>
+#include <stdlib.h>
 using namespace std;
 #include "compile.h"
+#include "dc.h"
+#include "bytecode.h"
+#include "sink.h"
+#include "profile.h"
+#include "alloctrack.h"
 
-const int CODE  = 100;
-const int STACK = 100;
-const int TEMPS = 100;
+const int CODE  = 1000000;
+const int STACK = 100000;
 
 int main( int argc, char *argv[] )
 {
     ifstream infile;
-    char fileLine[80];
+    string fileLine;
     VarTree vars;		// initially empty tree
     FunctionDef funs;
-    Instruction *program[CODE];	// space for CODE instructions
-    int stack[STACK];		// stack space for STACK values
-    int temps[TEMPS];		// up to TEMPS temporary registers
+    Instruction **program = new Instruction*[CODE];	// space for CODE instructions
+    Integer *stack = new Integer[STACK]();	// stack space for STACK values
+    Integer *temps;		// as many temporary registers as the code uses
 
     int progBegin = -1;		// where to begin execution
     int progEnd = 0;		// where program ends (first unused spot)
     int stackPointer;		// pointer to stack memory
     int programCounter;		// pointer to instruction
 
-    if (argc < 2)
+    bool profiling = false;	// -p: count and time every instruction
+    bool streaming = false;	// -s: read lines a piece at a time
+    bool runDc = false;		// -d: run the program as dc code instead
+    DcProgram dcProgram;	// that code, when it is wanted
+    bool runBytecode = false;	// -b: or as bytecode (see bytecode.h)
+    const char *statsName = NULL;	// -csv or -json: per-line measurements
+    bool statsJson = false;
+    const char *outName = NULL;	// -o, -o32 or -o64: where results go
+    int outBits = 0;		// and as binary integers of this size, if not 0
+    const char *fileName = NULL;
+    vector<string> lines;	// source lines, for the reports
+    vector<CompileTimes> times;	// time spent compiling each line
+
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        if (strcmp(argv[arg], "-p") == 0)
+            profiling = true;
+        else if (strcmp(argv[arg], "-s") == 0)
+            streaming = true;
+        else if (strcmp(argv[arg], "-n") == 0)
+            optimizeTrees = false;
+        else if (strcmp(argv[arg], "-u") == 0)
+            superinstructions = false;
+        else if (strcmp(argv[arg], "-d") == 0)
+            runDc = true;
+        else if (strcmp(argv[arg], "-b") == 0)
+            runBytecode = true;
+        else if ((strcmp(argv[arg], "-csv") == 0 || strcmp(argv[arg], "-json") == 0)
+                && arg + 1 < argc)
+        {
+            statsJson = strcmp(argv[arg], "-json") == 0;
+            statsName = argv[++arg];
+        }
+        else if ((strcmp(argv[arg], "-o") == 0 || strcmp(argv[arg], "-o32") == 0
+                    || strcmp(argv[arg], "-o64") == 0) && arg + 1 < argc)
+        {
+            outBits = atoi(argv[arg] + 2);
+            outName = argv[++arg];
+        }
+        else
+            fileName = argv[arg];
+    }
+
+    if (fileName == NULL)
     {
         cout << "Call this program with a name of a file afterwards" << endl;
+        cout << "    -p          profile the program as it runs" << endl;
+        cout << "    -s          stream each line into the compiler, without echoing it" << endl;
+        cout << "    -n          do not inline functions or fold constants" << endl;
+        cout << "    -u          do not fuse instructions into superinstructions" << endl;
+        cout << "    -d          run the program as dc code, in this process" << endl;
+        cout << "    -b          run the program as bytecode on a stack machine" << endl;
+        cout << "    -csv file   write per-line compile and run times as CSV" << endl;
+        cout << "    -json file  write per-line compile and run times as JSON" << endl;
+        cout << "    -o file     write the results to a file instead, as text" << endl;
+        cout << "    -o32 file   or as 32-bit binary integers (-o64, 64-bit)" << endl;
     }
     else
     {
-	    infile.open( argv[1] );
-	    while (infile.getline( fileLine, 100 ))
+	    infile.open( fileName );
+	    codeLimit = CODE;
+	    Bytecode bytecode( STACK );
+	    Bytecode *byteTarget = runBytecode ? &bytecode : NULL;
+	    ofstream outfile;
+	    TextSink textOut( outfile, false );
+	    BinarySink binaryOut( outfile, outBits );
+	    if (outName != NULL)
+	    {
+	        outfile.open( outName, ios::binary );
+	        resultSink = outBits == 0 ? (ResultSink *) &textOut : &binaryOut;
+	    }
+	    while (streaming && infile.peek() != EOF)
 	    {
-	        cout << fileLine << endl << endl;;
-	        compile( fileLine, vars, funs, program, progBegin, progEnd );
+	        CompileTimes lineTimes;
+	        compile( infile, vars, funs, program, progBegin, progEnd,
+	                lines.size(), &lineTimes, runDc ? &dcProgram : NULL, byteTarget );
+	        lines.push_back( "" );	// the text itself is never kept
+	        times.push_back( lineTimes );
+	    }
+	    while (getline( infile, fileLine ))
+	    {
+	        cout << fileLine << "\n\n";
+	        CompileTimes lineTimes;
+	        compile( fileLine.c_str(), vars, funs, program, progBegin, progEnd,
+	                lines.size(), &lineTimes, runDc ? &dcProgram : NULL, byteTarget );
+	        lines.push_back( fileLine );
+	        times.push_back( lineTimes );
         }
+	    if (runDc)
+	    {
+	        string code = dcPrelude() + dcProgram.code;
+	        cout << code << '\n';
+	        if (!dcProgram.complete())
+	            return 1;		// (the error was reported as it compiled)
+	        DcMachine dc;
+	        dc.run( dcProgram );
+	        resultSink->flush();
+	        return 0;
+	    }
+	    if (runBytecode)
+	    {
+	        bytecode.disassemble( cout );
+	        cout << bytecode.size() << " bytes\n\n";
+	        bytecode.run( vars.size() );
+	        resultSink->flush();
+	        return 0;
+	    }
+	    ALLOC_SCOPE( ALLOC_MACHINE );
+	    temps = new Integer[tempsNeeded + 1]();
 	    for (int i=0; i<progEnd; i++)
 	        cout << setw(2) << i << ": " << *program[i];
-        cout << endl;
-        programCounter = progBegin;
+        cout << '\n';
+        programCounter = progBegin < 0 ? progEnd : progBegin;
 	    stackPointer = STACK - vars.size();
-	    while (programCounter < progEnd)
+	    if (!profiling && statsName == NULL)
+	    {
+	        while (programCounter < progEnd)
+	        {
+	            programCounter++;		// prepare for the next
+	            program[programCounter-1]->execute( 	// but execute this one
+		        temps, stack, stackPointer, programCounter );
+	        }
+	    }
+	    else
 	    {
-	        programCounter++;		// prepare for the next
-	        program[programCounter-1]->execute( 	// but execute this one
-		    temps, stack, stackPointer, programCounter );	 
+	        Profiler profile( CODE );
+	        while (programCounter < progEnd)
+	        {
+	            int pc = programCounter++;	// remember which one is running
+	            unsigned long long start = readCycles();
+	            program[pc]->execute( temps, stack, stackPointer, programCounter );
+	            profile.record( pc, readCycles() - start );
+	        }
+	        if (profiling)
+	        {
+	            cout << endl;
+	            profile.report( cout, program, progEnd, lines );
+	        }
+	        if (statsName != NULL)
+	        {
+	            ofstream statsFile( statsName );
+	            profile.dumpLines( statsFile, statsJson, program, progEnd, lines, times );
+	        }
 	    }
+	    resultSink->flush();
     }
-}   
+}
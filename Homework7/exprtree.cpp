@@ -6,80 +6,200 @@
 // and evaluated.
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 using namespace std;
 #include "exprtree.h"
 #include "tokenlist.h"
+#include "checked.h"
 #include "machine.h"
+#include "dc.h"
+#include "bytecode.h"
+#include "alloctrack.h"
 
-// Outputting any tree node will simply output its string version
+// Outputting any tree node writes each of its nodes straight to the
+// stream, once; toString and makedc just collect the same in a string
 ostream& operator<<( ostream &stream, const ExprNode &e )
 {
-    return stream << e.toString();
+    e.write(stream);
+    return stream;
 }
 
+string ExprNode::toString() const
+{
+    ostringstream output;
+    write(output);
+    return output.str();
+}
+
+string ExprNode::makedc( DcProgram& program ) const
+{
+    ostringstream output;
+    writedc(output, program);
+    return output.str();
+}
+
+
 // A Value is just an integer value -- easy to evaluate
-// Unfortunately, the string class does not have a constructor for it
-string Value::toString() const
+void Value::write( ostream& stream ) const
 {
-    ostringstream convert;	// output string stream
-    convert << value;		// 'output' into the stream
-    return convert.str();	// and extract its string equivalent
+    stream << value;
 }
 
-int Value::evaluate( VarTree &v, FunctionDef& funs ) const
+Integer Value::evaluate( VarTree &v, FunctionDef& funs ) const
 {
     return value;
 }
 
-string Value::makedc() const
+//  dc takes a minus sign for subtraction, so a negative number is
+//  written with _ instead
+void Value::writedc( ostream& stream, DcProgram& program ) const
 {
-    return toString() + " ";
+    if (value < 0)
+        writeMagnitude(stream << '_', value);
+    else
+        stream << value;
+    stream << ' ';
 }
 
-int Value::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const
+int Value::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const
 {
     prog[progEnd++] = new Val(tempCounter, value);
     return tempCounter++;
 }
 
+void Value::toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const
+{
+    code.constant(value);
+}
+
+ExprNode* Value::optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena)
+{
+    if (params == NULL)
+        return this;
+    return new (arena) Value(value);
+}
+
+void Value::summarize(TreeSummary& s) const
+{
+    ++s.nodes;
+}
+
 //  A variable is just an alphabetic string -- easy to display
 //  To evaluate, would need to look it up in the data structure
+void Variable::write( ostream& stream ) const
+{
+    stream << name;
+}
+
 string Variable::toString() const
 {
     return name;
 }
 
-int Variable::evaluate( VarTree &v, FunctionDef& funs ) const
+Integer Variable::evaluate( VarTree &v, FunctionDef& funs ) const
 {
     return v.lookup( name );
 }
 
-string Variable::makedc() const
+//  Registers are only one character long, so each variable is given
+//  one of its own (see dc.h)
+void Variable::writedc( ostream& stream, DcProgram& program ) const
 {
-    stringstream output;
-    output << name[0]; //registers can only be one character long, so I'm making sure we only use one character for the register name
-    return output.str();
+    stream << 'l' << program.registerFor(name);
 }
 
-int Variable::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const
+// slotFor
+// Finds where a variable is kept -- its stack location, or its offset
+// in a function's frame.  A variable not seen before is given the next
+// one free, so that every variable has a place of its own.
+// Parameters:
+//     v    (modified VarTree) locations of the variables
+//     name (input string)     name of the variable
+// Returns:    its location
+static int slotFor( VarTree& v, const string& name )
 {
-    prog[progEnd++] = new VarLoad(tempCounter, v.lookup(name));
+    int known = v.size();
+    int slot = toInt(v.lookup(name));       // creates it (as 0) if new
+    if (v.size() > known)
+    {
+        v.assign(name, known);
+        slot = known;
+    }
+    return slot;
+}
+
+int Variable::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const
+{
+    if (local)
+        prog[progEnd++] = new FrameLoad(tempCounter, slotFor(v, name));
+    else
+        prog[progEnd++] = new VarLoad(tempCounter, slotFor(v, name));
     return tempCounter++;
 }
 
-string Operation::toString() const
+void Variable::toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const
 {
-    stringstream output;
+    code.op(local ? OP_LOAD_LOCAL : OP_LOAD, slotFor(v, name));
+}
 
-    output << left->toString() << " " << right->toString() << " " << oper;
+//  Inside an inlined body, a parameter becomes its argument, and any
+//  other variable is a local that is never assigned (see canInline),
+//  so it would always be 0.
+ExprNode* Variable::optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena)
+{
+    if (params == NULL)
+        return this;
+    Bindings::const_iterator arg = params->find(name);
+    if (arg == params->end())
+        return new (arena) Value(0);
+    return arg->second;
+}
 
-    return output.str();
+void Variable::summarize(TreeSummary& s) const
+{
+    ++s.nodes;
+    s.reads.push_back(name);
+}
+
+void Operation::write( ostream& stream ) const
+{
+    left->write(stream);
+    stream << ' ';
+    right->write(stream);
+    stream << ' ' << oper;
 }
 
-int Operation::evaluate(VarTree& v, FunctionDef& funs) const
+// arithmetic
+// Evaluates the operands, left first, and applies an arithmetic
+// operator to them.  When compiled with -DCHECKED, a result that is
+// not defined is reported along with this expression, and taken to be 0.
+inline Integer Operation::arithmetic( char op, VarTree &v, FunctionDef &funs ) const
+{
+    Integer a = left->evaluate(v, funs);
+    Integer b = right->evaluate(v, funs);
+#if defined(CHECKED)
+    Integer result;
+    const char *problem = checkedArithmetic( op, a, b, result );
+    if (problem == NULL)
+        return result;
+    cout << "Error: " << problem << " in " << *this << endl;
+    return 0;
+#else
+    switch (op)
+    {
+    case '+':   return a + b;
+    case '-':   return a - b;
+    case '*':   return a * b;
+    case '/':   return a / b;
+    default:    return a % b;
+    }
+#endif
+}
+
+Integer Operation::evaluate(VarTree& v, FunctionDef& funs) const
 {
     if (oper == "=") {
-        int value = right->evaluate(v, funs);
+        Integer value = right->evaluate(v, funs);
 
         v.assign(left->toString(), value);
 
@@ -87,23 +207,23 @@ int Operation::evaluate(VarTree& v, FunctionDef& funs) const
 
     } else if (oper == "+") {
 
-        return left->evaluate(v, funs) + right->evaluate(v, funs);
+        return arithmetic('+', v, funs);
 
     } else if (oper == "-") {
 
-        return left->evaluate(v, funs) - right->evaluate(v, funs);
+        return arithmetic('-', v, funs);
 
     } else if (oper == "*") {
 
-        return left->evaluate(v, funs) * right->evaluate(v, funs);
+        return arithmetic('*', v, funs);
 
     } else if (oper == "/") {
 
-        return left->evaluate(v, funs) / right->evaluate(v, funs);
+        return arithmetic('/', v, funs);
 
     } else if (oper == "%") {
 
-        return left->evaluate(v, funs) % right->evaluate(v, funs);
+        return arithmetic('%', v, funs);
 
     } else if (oper == ">") {
 
@@ -135,18 +255,20 @@ int Operation::evaluate(VarTree& v, FunctionDef& funs) const
     }
 }
 
-int Operation::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const
+int Operation::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const
 {
     if (oper == "=") {
-        int reg = right->toInstruction(prog, progEnd, tempCounter, v);
-        v.assign(left->toString(), v.size());
-        prog[progEnd++] = new VarAssign(reg, v.size() - 1);
+        int reg = right->toInstruction(prog, progEnd, tempCounter, v, funs, local);
+        if (local)
+            prog[progEnd++] = new FrameStore(reg, slotFor(v, left->toString()));
+        else
+            prog[progEnd++] = new VarAssign(reg, slotFor(v, left->toString()));
 
         return reg;
 
     } else {
-        int leftreg = left->toInstruction(prog, progEnd, tempCounter, v);
-        int rightreg = right->toInstruction(prog, progEnd, tempCounter, v);
+        int leftreg = left->toInstruction(prog, progEnd, tempCounter, v, funs, local);
+        int rightreg = right->toInstruction(prog, progEnd, tempCounter, v, funs, local);
 
         if (oper == "+") {
             prog[progEnd++] = new Add(tempCounter, leftreg, rightreg);
@@ -164,22 +286,22 @@ int Operation::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter
             prog[progEnd++] = new Mod(tempCounter, leftreg, rightreg);
             return tempCounter++;
         } else if (oper == ">") {
-            prog[progEnd++] = NULL;
+            prog[progEnd++] = new Greater(tempCounter, leftreg, rightreg);
             return tempCounter++;
         } else if (oper == "<") {
-            prog[progEnd++] = NULL;
+            prog[progEnd++] = new Less(tempCounter, leftreg, rightreg);
             return tempCounter++;
         } else if (oper == ">=") {
-            prog[progEnd++] = NULL;
+            prog[progEnd++] = new GreaterEqual(tempCounter, leftreg, rightreg);
             return tempCounter++;
         } else if (oper == "<=") {
-            prog[progEnd++] = NULL;
+            prog[progEnd++] = new LessEqual(tempCounter, leftreg, rightreg);
             return tempCounter++;
         } else if (oper == "==") {
-            prog[progEnd++] = NULL;
+            prog[progEnd++] = new Equal(tempCounter, leftreg, rightreg);
             return tempCounter++;
         } else if (oper == "!=") {
-            prog[progEnd++] = NULL;
+            prog[progEnd++] = new NotEqual(tempCounter, leftreg, rightreg);
             return tempCounter++;
         } else {
             cout << "Operation \"" << oper << "\" not recognized." << endl;
@@ -188,117 +310,427 @@ int Operation::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter
     }
 }
 
-string Operation::makedc() const
+//  An assignment stores its value, leaving it on the stack
+void Operation::toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const
 {
-    stringstream output;
-    Variable* leftvar  = dynamic_cast<Variable *>(left);  //Casts to a variable, returning null if it is not actually of type Variable
-    Variable* rightvar = dynamic_cast<Variable *>(right); //This allows us to test later if left is a variable or a value
+    if (oper == "=") {
+        right->toBytecode(code, v, funs, local);
+        code.op(local ? OP_STORE_LOCAL : OP_STORE, slotFor(v, left->toString()));
+        return;
+    }
+    left->toBytecode(code, v, funs, local);
+    right->toBytecode(code, v, funs, local);
+
+    if (oper == "+")
+        code.op(OP_ADD);
+    else if (oper == "-")
+        code.op(OP_SUB);
+    else if (oper == "*")
+        code.op(OP_MUL);
+    else if (oper == "/")
+        code.op(OP_DIV);
+    else if (oper == "%")
+        code.op(OP_MOD);
+    else if (oper == ">")
+        code.op(OP_GT);
+    else if (oper == "<")
+        code.op(OP_LT);
+    else if (oper == ">=")
+        code.op(OP_GE);
+    else if (oper == "<=")
+        code.op(OP_LE);
+    else if (oper == "==")
+        code.op(OP_EQ);
+    else if (oper == "!=")
+        code.op(OP_NE);
+    else
+        cout << "Operation \"" << oper << "\" not recognized." << endl;
+}
 
-    if (oper == "~")
-    {
-        output << "_";
-        
-        if (leftvar)
-            output << "l";
-        output << left->makedc();
+// foldConstants
+// Applies an operator to two constants at compile time
+// Arithmetic whose result would not be defined (overflow, or division
+// by zero) is not folded, but left to behave at run time as it always did.
+// Parameters:
+//     oper   (input string)   the operator
+//     a, b   (input Integer)  the operands
+//     result (output Integer) the result, if there is one
+// Returns:    whether there is a result
+static bool foldConstants( const string& oper, const Integer& a, const Integer& b, Integer& result )
+{
+    if (oper == "+" || oper == "-" || oper == "*" || oper == "/" || oper == "%")
+        return checkedArithmetic(oper[0], a, b, result) == NULL;
+    else if (oper == ">")
+        result = a > b;
+    else if (oper == "<")
+        result = a < b;
+    else if (oper == ">=")
+        result = a >= b;
+    else if (oper == "<=")
+        result = a <= b;
+    else if (oper == "==")
+        result = a == b;
+    else if (oper == "!=")
+        result = a != b;
+    else
+        return false;
+    return true;
+}
 
-    }
-    else if (oper == "=")
-    {    
-        if (rightvar)
-            output << "l";
-        output << right->makedc();
-
-        output << "s" << left->makedc();
-        output << "l" << left->makedc(); //This loads the value back on to the stack.
-                                         //Otherwise, a statement like A = 2 + (B = 3) would fail
-                                         //This also allows us to print the value of the last assignment easily
-    }
-    else if (oper == ">" || oper == "<" || oper == ">=" || oper == "<=" || oper == "==" || oper == "!=")
+ExprNode* Operation::optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena)
+{
+    ExprNode* l = left;             // the target of an assignment stays as it is
+    if (oper != "=")
+        l = left->optimize(funs, params, arena);
+    ExprNode* r = right->optimize(funs, params, arena);
+
+    Value* leftval  = dynamic_cast<Value *>(l);
+    Value* rightval = dynamic_cast<Value *>(r);
+    Integer result;
+    if (leftval && rightval && foldConstants(oper, leftval->number(), rightval->number(), result))
+        return new (arena) Value(result);
+
+    if (l == left && r == right && params == NULL)
+        return this;
+    return new (arena) Operation(l, oper, r);
+}
+
+void Operation::summarize(TreeSummary& s) const
+{
+    ++s.nodes;
+    if (oper == "=")
     {
-        output << " Comparison operators not supported. "; //This is because comparison operators cannot run without
-                                                           //running a macro stored in a register, which would be
-                                                           //too difficult to implement acceptably
+        s.assigns = true;
+        ++s.nodes;                  // for the target, which is not read
+        s.targets.insert(left->toString());
     }
     else
-    {
-        if (leftvar)
-            output << "l";
-        output << left->makedc();
+        left->summarize(s);
+    right->summarize(s);
+}
 
-        if (rightvar)
-            output << "l";
-        output << right->makedc();
+//  An assignment leaves a copy of the value on the stack, for any
+//  larger expression around it (and for it to be printed).
+//  A comparison puts a 0 beneath its operands, which the macro set
+//  aside for it replaces with 1 if it holds (see dcPrelude).
+void Operation::writedc( ostream& stream, DcProgram& program ) const
+{
+    if (oper == "=")
+    {
+        right->writedc(stream, program);
+        stream << "ds" << program.registerFor(left->toString());
+        return;
+    }
 
-        output << oper;
+    bool arithmetic = (oper == "+" || oper == "-" || oper == "*" || oper == "/" || oper == "%");
+    if (!arithmetic)
+        stream << "0 ";
+    left->writedc(stream, program);
+    right->writedc(stream, program);
+    if (arithmetic)
+    {
+        stream << oper;
+        return;
     }
 
-    return output.str();
+    // dc compares the top to the one beneath
+    if (oper == ">")
+        stream << '<';
+    else if (oper == "<")
+        stream << '>';
+    else if (oper == ">=")
+        stream << "!>";
+    else if (oper == "<=")
+        stream << "!<";
+    else if (oper == "==")
+        stream << '=';
+    else
+        stream << "!=";
+    stream << DC_TRUE;
 }
 
 
-string Conditional::toString() const
+void Conditional::write( ostream& stream ) const
 {
-    return "((" + test->toString() + ") ? (" + trueCase->toString() + ") : (" + falseCase->toString() + "))";
+    stream << "((";
+    test->write(stream);
+    stream << ") ? (";
+    trueCase->write(stream);
+    stream << ") : (";
+    falseCase->write(stream);
+    stream << "))";
 }
 
-int Conditional::evaluate(VarTree& v, FunctionDef& funs) const
+Integer Conditional::evaluate(VarTree& v, FunctionDef& funs) const
 {
     return test->evaluate(v, funs) ? trueCase->evaluate(v, funs) : falseCase->evaluate(v, funs);
 }
 
-string Conditional::makedc() const
+//  Both cases are pushed as strings, and swapped if the test holds;
+//  the one then on top is thrown away, and the other is run
+void Conditional::writedc( ostream& stream, DcProgram& program ) const
 {
-    return " Conditional operator not supported. ";
+    stream << '[';
+    falseCase->writedc(stream, program);
+    stream << "][";
+    trueCase->writedc(stream, program);
+    stream << ']';
+    test->writedc(stream, program);
+    stream << "0!=" << DC_SWAP << 's' << DC_DISCARD << 'x';
 }
 
-int Conditional::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const
+//  The test branches around the code for the true case, and the
+//  true case jumps past the false case; each leaves its value in
+//  the same register.  The branches are filled in once their
+//  destinations are known.
+int Conditional::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const
 {
-    return 0; //unsupported
+    int result = tempCounter++;
+    int testReg = test->toInstruction(prog, progEnd, tempCounter, v, funs, local);
+    int branch = progEnd++;
+
+    int trueReg = trueCase->toInstruction(prog, progEnd, tempCounter, v, funs, local);
+    prog[progEnd++] = new Move(result, trueReg);
+    int jump = progEnd++;
+
+    prog[branch] = new BranchFalse(testReg, progEnd);
+    int falseReg = falseCase->toInstruction(prog, progEnd, tempCounter, v, funs, local);
+    prog[progEnd++] = new Move(result, falseReg);
+    prog[jump] = new Jump(progEnd);
+
+    return result;
 }
 
-string Function::toString() const
+//  Only one of the cases runs, so each starts from the same depth
+void Conditional::toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const
 {
-    stringstream output;
+    test->toBytecode(code, v, funs, local);
+    int branch = code.jump(OP_JUMP_FALSE);
+    int depth = code.depth();
 
-    output << name;
-    output << "(";
+    trueCase->toBytecode(code, v, funs, local);
+    int jump = code.jump(OP_JUMP);
 
-    for (int i = 0; i < 10 && params[i] != NULL; ++i)
+    code.land(branch);
+    code.setDepth(depth);
+    falseCase->toBytecode(code, v, funs, local);
+    code.land(jump);
+}
+
+//  A constant test chooses one case outright
+ExprNode* Conditional::optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena)
+{
+    ExprNode* b = test->optimize(funs, params, arena);
+    Value* constant = dynamic_cast<Value *>(b);
+    if (constant)
+        return (constant->number() ? trueCase : falseCase)->optimize(funs, params, arena);
+
+    ExprNode* t = trueCase->optimize(funs, params, arena);
+    ExprNode* f = falseCase->optimize(funs, params, arena);
+    if (b == test && t == trueCase && f == falseCase && params == NULL)
+        return this;
+    return new (arena) Conditional(b, t, f);
+}
+
+void Conditional::summarize(TreeSummary& s) const
+{
+    ++s.nodes;
+    s.branches = true;
+    test->summarize(s);
+    trueCase->summarize(s);
+    falseCase->summarize(s);
+}
+
+//  The arguments are copied into an array of exactly the right size,
+//  kept in the same arena as the node itself
+Function::Function(FunDef* _function, const vector<ExprNode*>& args, NodeArena& arena)
+{
+    function = _function;
+    argc = args.size();
+    params = NULL;
+    if (argc > 0)
     {
-        output << "(" << *params[i] << ")";
-        if (params[i+1] != NULL)
-            output << ",";
+        params = static_cast<ExprNode**>(arena.allocatePlain(argc * sizeof(ExprNode*)));
+        copy(args.begin(), args.end(), params);
     }
+}
 
-    output << ")";
+void Function::write( ostream& stream ) const
+{
+    stream << function->name << '(';
+    for (int i = 0; i < argc; ++i)
+    {
+        stream << '(';
+        params[i]->write(stream);
+        stream << ')';
+        if (i + 1 < argc)
+            stream << ',';
+    }
+    stream << ')';
+}
 
+//  The call was bound to its function when it was parsed, but the
+//  function might not have been defined since
+Integer Function::evaluate(VarTree& v, FunctionDef& funs) const
+{
+    if (function->functionBody == NULL)
+    {
+        cout << "Function \"" << function->name << "\" is not defined." << endl;
+        return 0;
+    }
+    ALLOC_SCOPE( ALLOC_TREE );
+    VarTree localtree;  //multiple recursive calls (like in the basic fibonacci function)
+                        //cause issues with overwriting, so we make a new vartree for each 
+                        //function call, which deletes its variables when the call returns
+    int count = min(argc, (int) function->parameter.size());
+    for (int i = 0; i < count; ++i)
+        localtree.assign(function->parameter[i], params[i]->evaluate(v, funs));
+
+    return function->functionBody->evaluate(localtree, funs);
+}
+
+//  The arguments are left on the stack for the function's macro;
+//  once it is defined, any missing are given as 0, and any extra
+//  are worked out but then dropped
+void Function::writedc( ostream& stream, DcProgram& program ) const
+{
+    for (int i = 0; i < argc; ++i)
+        params[i]->writedc(stream, program);
+    if (function->functionBody != NULL)
+    {
+        int count = function->parameter.size();
+        for (int i = argc; i < count; ++i)
+            stream << "0 ";
+        for (int i = count; i < argc; ++i)
+            stream << 's' << DC_DISCARD;
+    }
+    stream << 'l' << program.registerFor(function->name, true) << 'x';
+}
+
+//  Each parameter, and every other variable the body names, is pushed
+//  onto its register's own stack while the body runs (a local starting
+//  at 0), and popped off again after, so the caller's are undisturbed
+string makedcDefinition( const FunDef& function, DcProgram& program )
+{
+    TreeSummary body;
+    function.functionBody->summarize(body);
+    set<string> locals(body.reads.begin(), body.reads.end());
+    locals.insert(body.targets.begin(), body.targets.end());
+
+    string enter, leave;
+    for (size_t i = function.parameter.size(); i-- > 0; )
+    {
+        enter += string("S") + program.registerFor(function.parameter[i]);
+        leave = string("L") + program.registerFor(function.parameter[i]) + "s" + DC_DISCARD + leave;
+        locals.erase(function.parameter[i]);
+    }
+    for (set<string>::iterator local = locals.begin(); local != locals.end(); ++local)
+    {
+        enter += string("0S") + program.registerFor(*local);
+        leave = string("L") + program.registerFor(*local) + "s" + DC_DISCARD + leave;
+    }
+
+    ostringstream output;
+    output << '[' << enter;
+    function.functionBody->writedc(output, program);
+    output << leave << "]s" << program.registerFor(function.name, true);
     return output.str();
 }
 
-int Function::evaluate(VarTree& v, FunctionDef& funs) const
+//  The function's code is generated when it is defined (see compile.cpp),
+//  so a call need only evaluate the arguments and jump to it.
+//  Every register in use so far is preserved across the call.
+//  A call to a function not yet compiled is given its entry later,
+//  when it is (and if it never is, reports that when it is made).
+int Function::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const
 {
-    FunDef* function = &funs[name]; //using location to avoid unnecessary copying
-    VarTree* localtree = new VarTree(); //multiple recursive calls (like in the basic fibonacci function)
-                                        //cause issues with overwriting, so we make a new vartree for each 
-                                        //function call
-    for (int i = 0; i < 10 && function->parameter[i] != ""; ++i)
-        localtree->assign(function->parameter[i], params[i]->evaluate(v, funs));
+    vector<int> args(argc);
+    for (int i = 0; i < argc; ++i)
+        args[i] = params[i]->toInstruction(prog, progEnd, tempCounter, v, funs, local);
+
+    if (function->entry < 0)
+        function->unresolved.push_back(progEnd);
+    prog[progEnd++] = new Call(tempCounter, function->entry, args,
+            function->parameter.size(), tempCounter);
+    return tempCounter++;
+}
 
-    int result = function->functionBody->evaluate(*localtree, funs);
+//  The arguments are left on the stack, to begin the function's frame
+void Function::toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const
+{
+    for (int i = 0; i < argc; ++i)
+        params[i]->toBytecode(code, v, funs, local);
+    code.call(function, argc);
+}
 
-    delete localtree; //remove the localtree. technically, there's a memory leak here, as the destructor for
-                      //vartree does not delete the nodes, but there's nothing I can really do about that
+// canInline
+// Decides whether a call may be replaced by a copy of the function body
+// The function itself must be small, not recursive, and assign to
+// nothing (see compile.cpp).  Every argument must be given, and free of
+// side effects.  The call works out each argument exactly once, in
+// order, before the body; so unless an argument is a single value or
+// variable, the copy must also read it exactly once (not in some case
+// of a conditional), and in the same order as the others -- else work
+// would be repeated, or a division by zero skipped or moved.
+// Parameters:
+//     function (input FunDef)      the function called
+//     args     (input vector)      the arguments of the call
+// Returns:    whether the call may be inlined
+static bool canInline( const FunDef& function, const vector<ExprNode*>& args )
+{
+    if (!function.inlinable || args.size() != function.parameter.size())
+        return false;
 
-    return result;
+    TreeSummary body;
+    function.functionBody->summarize(body);
+    vector<string>::iterator next = body.reads.begin();
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        TreeSummary arg;
+        args[i]->summarize(arg);
+        if (arg.assigns)
+            return false;
+        if (arg.nodes == 1)
+            continue;
+
+        const string& param = function.parameter[i];
+        if (body.branches || count(body.reads.begin(), body.reads.end(), param) != 1)
+            return false;
+        next = find(next, body.reads.end(), param);
+        if (next == body.reads.end())
+            return false;
+        ++next;
+    }
+    return true;
 }
 
-string Function::makedc() const
+ExprNode* Function::optimize(FunctionDef& funs, const Bindings* bindings, NodeArena& arena)
 {
-    return " Functions not supported. ";
+    vector<ExprNode*> args(argc);
+    bool changed = false;
+    for (int i = 0; i < argc; ++i)
+    {
+        args[i] = params[i]->optimize(funs, bindings, arena);
+        changed = changed || args[i] != params[i];
+    }
+
+    if (canInline(*function, args))
+    {
+        Bindings inner;
+        for (int i = 0; i < argc; ++i)
+            inner[function->parameter[i]] = args[i];
+        return function->functionBody->optimize(funs, &inner, arena);
+    }
+
+    if (!changed && bindings == NULL)
+        return this;
+    return new (arena) Function(function, args, arena);
 }
 
-int Function::toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const
+void Function::summarize(TreeSummary& s) const
 {
-    return 0; //unsupported
+    ++s.nodes;
+    s.calls.insert(function->name);
+    for (int i = 0; i < argc; ++i)
+        params[i]->summarize(s);
 }
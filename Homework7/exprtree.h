@@ -4,35 +4,101 @@
 //  All objects in this structure are immutable --
 //  once constructed, they are never changed.
 //  They only be displayed or evaluated.
+//  Nodes are always allocated from a NodeArena (see arena.h),
+//  which destroys a whole tree at once.
 #include <iostream>
+#include <map>
+#include <set>
+#include <vector>
 using namespace std;
 #include "vartree.h"
+#include "arena.h"
 #include "funmap.h"
 #include "machine.h"
 
+class ExprNode;
+class Bytecode;
+class DcProgram;
+
+// What the optimizer needs to know about a subtree (see summarize)
+struct TreeSummary
+{
+    int nodes;                  // how many nodes it has
+    bool assigns;               // whether it assigns to any variable
+    bool branches;              // whether it has a conditional
+    set<string> calls;          // the functions it calls
+    set<string> targets;        // the variables it assigns to
+    vector<string> reads;       // the variables read, in order
+    TreeSummary()
+    {
+        nodes = 0;
+        assigns = false;
+        branches = false;
+    }
+};
+
+// The argument standing in for each parameter of a function
+// whose body is being inlined
+typedef map<string, ExprNode*> Bindings;
+
 class ExprNode
 {
     public:
+    virtual ~ExprNode() {}
+    void* operator new( size_t size, NodeArena& arena )
+    {
+        return arena.allocate( size );
+    }
+    void operator delete( void* p, NodeArena& arena )	// only if a constructor throws
+    {
+        arena.discard( p );
+    }
     friend ostream& operator<<( ostream&, const ExprNode & );
-    virtual string toString() const = 0;	// facilitates << operator
-    virtual int evaluate( VarTree &v, FunctionDef& funs ) const = 0;  // evaluate this node
-    virtual string makedc() const = 0;
-    virtual int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const = 0;
+    virtual void write( ostream& ) const = 0;	// facilitates << operator
+    virtual string toString() const;		// the same, as a string
+    virtual Integer evaluate( VarTree &v, FunctionDef& funs ) const = 0;  // evaluate this node
+    // dc code leaving its value on the stack, with the registers of
+    // the program it is part of (see dc.h)
+    virtual void writedc( ostream&, DcProgram& ) const = 0;
+    string makedc( DcProgram& ) const;		// the same, as a string
+    // generate code, returning the register holding the result
+    // v gives each variable's stack location, or when local is true,
+    // its offset in the frame of the function being compiled
+    virtual int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const = 0;
+    // generate bytecode leaving its value on the stack (see bytecode.h),
+    // with v and local as for toInstruction
+    virtual void toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const = 0;
+    // produce an equivalent tree, with small functions inlined and
+    // constant operations worked out; any new nodes come from arena.
+    // When params is not NULL, this is the body of an inlined function,
+    // and its parameters are replaced by their arguments; every node of
+    // the result is then new, so the copy outlives the body it came from.
+    virtual ExprNode* optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena) = 0;
+    virtual void summarize(TreeSummary& s) const = 0;
+    protected:
+    void operator delete( void* ) {}	// nodes are only freed by their arena
 };
 
 class Value: public ExprNode
 {
     private:
-        int value;
+        Integer value;
     public:
-        string toString() const;	// facilitates << operator
-        int evaluate( VarTree &v, FunctionDef& funs ) const;
-        Value(int v)
+        void write( ostream& ) const;
+        Integer evaluate( VarTree &v, FunctionDef& funs ) const;
+        Value(Integer v)
         {
             value = v;
         }
-        string makedc() const;
-        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const;
+        Integer number() const
+        {
+            return value;
+        }
+        void writedc( ostream&, DcProgram& ) const;
+        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const;
+        void toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const;
+        ExprNode* optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena);
+        void summarize(TreeSummary& s) const;
 };
 
 class Variable: public ExprNode
@@ -40,14 +106,18 @@ class Variable: public ExprNode
     private:
         string name;
     public:
-        string toString() const ;	// facilitates << operator
-        int evaluate( VarTree &v, FunctionDef& funs ) const;
+        void write( ostream& ) const;
+        string toString() const;	// just the name
+        Integer evaluate( VarTree &v, FunctionDef& funs ) const;
         Variable(string var)
         {
             name = var;
         }
-        string makedc() const;
-        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const;
+        void writedc( ostream&, DcProgram& ) const;
+        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const;
+        void toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const;
+        ExprNode* optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena);
+        void summarize(TreeSummary& s) const;
 };
 
 class Operation: public ExprNode
@@ -55,17 +125,21 @@ class Operation: public ExprNode
     private:
         string oper;
         ExprNode *left, *right;	 // operands
+        Integer arithmetic( char, VarTree &v, FunctionDef &funs ) const;
     public:
-        string toString() const;	// facilitates << operator
-        int evaluate( VarTree &v, FunctionDef& funs ) const;
+        void write( ostream& ) const;
+        Integer evaluate( VarTree &v, FunctionDef& funs ) const;
         Operation( ExprNode *l, string o, ExprNode *r )
         {
             left = l;
             right = r;
             oper = o;
         }
-        string makedc() const;
-        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const;
+        void writedc( ostream&, DcProgram& ) const;
+        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const;
+        void toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const;
+        ExprNode* optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena);
+        void summarize(TreeSummary& s) const;
 };
 
 class Conditional: public ExprNode
@@ -73,32 +147,39 @@ class Conditional: public ExprNode
     private:
         ExprNode *test, *trueCase, *falseCase;
     public:
-        string toString() const;	// facilitates << operator
-        int evaluate( VarTree &v, FunctionDef& funs ) const;
+        void write( ostream& ) const;
+        Integer evaluate( VarTree &v, FunctionDef& funs ) const;
         Conditional( ExprNode *b, ExprNode *t, ExprNode *f)
         {
             test = b;
             trueCase = t;
             falseCase = f;
         }
-        string makedc() const;
-        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const;
+        void writedc( ostream&, DcProgram& ) const;
+        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const;
+        void toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const;
+        ExprNode* optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena);
+        void summarize(TreeSummary& s) const;
 };
 
 class Function : public ExprNode
 {
     private:
-        string name;
-        ExprNode* params[10];
+        FunDef* function;	// bound when the call is parsed
+        int argc;		// how many arguments there are
+        ExprNode** params;	// the arguments, kept in the same arena
     public:
-        string toString() const;
-        int evaluate(VarTree& v, FunctionDef& funs) const;
-        Function(string _name, ExprNode* _params[10])
-        {
-            name = _name;
-            for (int i = 0; i < 10; ++i)
-                params[i] = _params[i];
-        }
-        string makedc() const;
-        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v) const;
+        void write( ostream& ) const;
+        Integer evaluate(VarTree& v, FunctionDef& funs) const;
+        Function(FunDef* _function, const vector<ExprNode*>& args, NodeArena& arena);
+        void writedc( ostream&, DcProgram& ) const;
+        int toInstruction(Instruction* prog[], int& progEnd, int& tempCounter, VarTree& v, FunctionDef& funs, bool local) const;
+        void toBytecode(Bytecode& code, VarTree& v, FunctionDef& funs, bool local) const;
+        ExprNode* optimize(FunctionDef& funs, const Bindings* params, NodeArena& arena);
+        void summarize(TreeSummary& s) const;
 };
+
+// makedcDefinition
+// The dc code that stores a function's macro in its register
+// The macro takes the arguments from the stack and leaves the result.
+string makedcDefinition( const FunDef& function, DcProgram& program );
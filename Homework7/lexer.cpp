@@ -0,0 +1,115 @@
+// Lexer Implementation File
+// Tokens are recognized by scanToken (see tokenlist.h), exactly as the
+// TokenList constructor does.  When reading a stream, a token may run
+// past the end of what is in the buffer; in that case the buffer is
+// refilled, keeping the start of that token, and it is scanned again.
+
+#include <iostream>
+using namespace std;
+
+#include "lexer.h"
+#include "tokenlist.h"
+#include "scanner.h"
+#include "alloctrack.h"
+
+const size_t BUFFER_SIZE = 65536;   // starting size of a stream buffer
+
+// Lexer constructor
+// Prepares to read the tokens of a character string
+// Parameters:
+//     expr    (input char array)  string to examine, which must
+//                                 outlive the lexer
+Lexer::Lexer( const char expr[] )
+{
+    position = expr;
+    source = NULL;
+    buffer = NULL;
+    capacity = 0;
+    lineDone = true;
+    scan();
+}
+
+// Lexer constructor
+// Prepares to read the tokens of the next line of a stream
+// The newline at the end of the line is read, but no further.
+// Parameters:
+//     in      (modified istream)  stream to read from
+Lexer::Lexer( istream &in )
+{
+    ALLOC_SCOPE( ALLOC_TOKENIZER );
+    source = &in;
+    capacity = BUFFER_SIZE;
+    buffer = new char[capacity];
+    buffer[0] = '\0';
+    position = buffer;
+    lineDone = false;
+    scan();
+}
+
+//  scan
+//  Finds the next token, refilling the buffer if need be
+void Lexer::scan()
+{
+    for (;;)
+    {
+        const char *start = skipBlanks(position);
+        const char *end = start;
+        if (*start != '\0')
+            end = scanToken(start, current);
+
+        //  A token that stops at the end of the buffer might go on
+        //  further, so if there is more to read, read it and look again
+        if (*end == '\0' && refill(start))
+        {
+            position = buffer;
+            continue;
+        }
+
+        finished = (start == end);
+        position = end;
+        return;
+    }
+}
+
+//  refill
+//  Reads more of the line into the buffer, keeping whatever has not
+//  yet been made into a token, and growing the buffer if that is
+//  already too much to leave room for more
+//  Parameters:
+//      keep    (input char pointer)    first character to keep
+//  Returns:    whether there was any more to read
+bool Lexer::refill( const char *keep )
+{
+    if (source == NULL || lineDone)
+        return false;
+
+    ALLOC_SCOPE( ALLOC_TOKENIZER );
+    size_t kept = char_traits<char>::length(keep);
+    if (kept + 1 >= capacity / 2)
+    {
+        char *larger = new char[capacity * 2];
+        char_traits<char>::copy(larger, keep, kept);
+        delete [] buffer;
+        buffer = larger;
+        capacity *= 2;
+    }
+    else
+        char_traits<char>::move(buffer, keep, kept);
+
+    //  get() stops before the newline, which is then read separately
+    source->get(buffer + kept, capacity - kept, '\n');
+    size_t read = source->gcount();
+    if (source->fail() && read == 0)
+        source->clear(source->rdstate() & ~ios::failbit);
+    buffer[kept + read] = '\0';
+
+    if (source->peek() == '\n')
+    {
+        source->ignore();
+        lineDone = true;
+    }
+    else if (!source->good())
+        lineDone = true;
+
+    return read > 0;
+}
@@ -0,0 +1,76 @@
+#ifndef LEXER_H
+#define LEXER_H
+// Lexer Header File
+// A tokenizer the parser pulls tokens from one at a time, instead of
+// a TokenList built for the whole line before parsing begins.
+// Only the current token (one token of lookahead) is ever held, so the
+// memory needed to parse does not grow with the length of the line.
+//
+// A Lexer reads either a character string, or one line of an input
+// stream.  A stream is read through a buffer of modest size that is
+// refilled as tokens are used up, so even an enormous generated
+// expression never has to be held in memory all at once.
+
+#include <iostream>
+#include <string>
+using namespace std;
+
+#include "token.h"
+
+class Lexer
+{
+    private:
+        Token current;          // the token under examination
+        bool finished;          // whether every token has been used
+        const char *position;   // next character to be scanned
+        istream *source;        // stream to read more from, or NULL
+        char *buffer;           // characters read from the stream
+        size_t capacity;        // size of that buffer
+        bool lineDone;          // whether the rest of the line is in the buffer
+
+        void scan();
+        bool refill( const char * );
+
+        Lexer( const Lexer& );              // lexers are never copied
+        Lexer& operator=( const Lexer& );
+    public:
+        Lexer( const char expr[] );
+        Lexer( istream &in );
+        ~Lexer()
+        {
+            delete [] buffer;
+        }
+
+        // Much like a ListIterator, for the parsers' convenience
+        const Token& token() const
+        {
+            return current;
+        }
+        char tokenChar() const
+        {
+            return finished ? 0 : current.tokenChar();
+        }
+        string tokenText() const
+        {
+            return finished ? "" : current.tokenText();
+        }
+        bool currentIsInteger() const
+        {
+            return current.isInteger();
+        }
+        Integer integerValue() const
+        {
+            return current.integerValue();
+        }
+        bool done() const
+        {
+            return finished;
+        }
+        void advance()
+        {
+            if (!finished)
+                scan();
+        }
+};
+
+#endif
@@ -6,7 +6,7 @@
 //
 // The machine is expected to have a pre-allocated stack space
 // for named variables and an arbitrarily long list of temporary
-// registers, both represented by integer arrays here (to hold values).
+// registers, both represented by arrays of Integer here (see value.h).
 // The machine also has a separate memory area holding all of the
 // instructions defined below.
 
@@ -15,6 +15,8 @@
 using namespace std;
 
 #include "machine.h"
+#include "sink.h"
+#include "checked.h"
 
 ostream& operator<<( ostream &stream, const Instruction &i )
 {
@@ -31,9 +33,9 @@ string Print::toString() const
     return ss.str();
 }
 
-void Print::execute(int regs[], int stack[], int& stackPointer, int& programCounter) const
+void Print::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
 {
-    cout << regs[valueTemp] << endl;
+    resultSink->put( regs[valueTemp] );
 }
 
 string Val::toString() const
@@ -43,7 +45,7 @@ string Val::toString() const
     return ss.str();
 }
 
-void Val::execute(int regs[], int stack[], int& stackPointer, int& programCounter) const
+void Val::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
 {
     regs[valueTemp] = val;
 }
@@ -55,7 +57,7 @@ string VarAssign::toString() const
     return ss.str();
 }
 
-void VarAssign::execute(int regs[], int stack[], int& stackPointer, int& programCounter) const
+void VarAssign::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
 {
     stack[stackLoc] = regs[valueTemp];
 }
@@ -67,7 +69,7 @@ string VarLoad::toString() const
     return ss.str();
 }
 
-void VarLoad::execute(int regs[], int stack[], int& stackPointer, int& programCounter) const
+void VarLoad::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
 {
     regs[valueTemp] = stack[stackLoc];
 }
@@ -79,27 +81,327 @@ string Compute::toString() const
     return ss.str();
 }
 
-void Add::execute(int regs[], int stack[], int& stackPointer, int& programCounter) const
+//  computeArithmetic
+//  Applies one arithmetic operator to two values.
+//  When compiled with -DCHECKED, a result that is not defined is
+//  reported along with the instruction and its source line, and
+//  taken to be 0.
+//  Parameters:
+//      op      (input char)            the operator, one of + - * / %
+//      a, b    (input Integer)         the operands
+//      result  (output Integer)        the result
+//      where   (input Instruction)     the instruction computing it
+static inline void computeArithmetic( char op, const Integer &a, const Integer &b,
+        Integer &result, const Instruction &where )
 {
-    regs[valueTemp] = regs[argA] + regs[argB];
+#if defined(CHECKED)
+    const char *problem = checkedArithmetic( op, a, b, result );
+    if (problem != NULL)
+    {
+        string text = where.toString();
+        text.erase( text.size() - 1 );          // its newline
+        cout << "Error: " << problem << " in " << text;
+        if (where.sourceLine() >= 0)
+            cout << " (line " << where.sourceLine() + 1 << ")";
+        cout << endl;
+        result = 0;
+    }
+#else
+    (void) where;               // only needed to report a problem
+    switch (op)
+    {
+    case '+':   result = a + b;     break;
+    case '-':   result = a - b;     break;
+    case '*':   result = a * b;     break;
+    case '/':   result = a / b;     break;
+    default:    result = a % b;     break;
+    }
+#endif
 }
 
-void Subtract::execute(int regs[], int stack[], int& stackPointer, int& programCounter) const
+//  arithmetic
+//  Computes the result register from the two operand registers
+//  Parameters:
+//      op      (input char)            the operator, one of + - * / %
+//      regs    (modified Integer array) the temporary registers
+inline void Compute::arithmetic( char op, Integer regs[] ) const
 {
-    regs[valueTemp] = regs[argA] - regs[argB];
+    computeArithmetic( op, regs[argA], regs[argB], regs[valueTemp], *this );
 }
 
-void Multiply::execute(int regs[], int stack[], int& stackPointer, int& programCounter) const
+void Add::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
 {
-    regs[valueTemp] = regs[argA] * regs[argB];
+    arithmetic('+', regs);
 }
 
-void Divide::execute(int regs[], int stack[], int& stackPointer, int& programCounter) const
+void Subtract::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
 {
-    regs[valueTemp] = regs[argA] / regs[argB];
+    arithmetic('-', regs);
 }
 
-void Mod::execute(int regs[], int stack[], int& stackPointer, int& programCounter) const
+void Multiply::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
 {
-    regs[valueTemp] = regs[argA] % regs[argB];
+    arithmetic('*', regs);
+}
+
+void Divide::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    arithmetic('/', regs);
+}
+
+void Mod::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    arithmetic('%', regs);
+}
+
+void Less::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    regs[valueTemp] = regs[argA] < regs[argB];
+}
+
+void Greater::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    regs[valueTemp] = regs[argA] > regs[argB];
+}
+
+void LessEqual::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    regs[valueTemp] = regs[argA] <= regs[argB];
+}
+
+void GreaterEqual::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    regs[valueTemp] = regs[argA] >= regs[argB];
+}
+
+void Equal::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    regs[valueTemp] = regs[argA] == regs[argB];
+}
+
+void NotEqual::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    regs[valueTemp] = regs[argA] != regs[argB];
+}
+
+string Move::toString() const
+{
+    stringstream ss;
+    ss << "T" << valueTemp << " = T" << fromReg << endl;
+    return ss.str();
+}
+
+void Move::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    regs[valueTemp] = regs[fromReg];
+}
+
+string Jump::toString() const
+{
+    stringstream ss;
+    ss << "goto " << target << endl;
+    return ss.str();
+}
+
+void Jump::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    programCounter = target;
+}
+
+string BranchFalse::toString() const
+{
+    stringstream ss;
+    ss << "if T" << valueTemp << " == 0 goto " << target << endl;
+    return ss.str();
+}
+
+void BranchFalse::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    if (!regs[valueTemp])
+        programCounter = target;
+}
+
+string Call::toString() const
+{
+    stringstream ss;
+    ss << "T" << valueTemp << " = call ";
+    if (entry < 0)
+        ss << "?";
+    else
+        ss << entry;
+    ss << "(";
+    for (size_t i = 0; i < args.size(); ++i)
+        ss << (i > 0 ? ", T" : "T") << args[i];
+    ss << ")";
+    if (saved > 0)
+        ss << " saving T0-T" << saved - 1;
+    ss << endl;
+    return ss.str();
+}
+
+//  stackOverflow
+//  Reports that a call found no room on the stack, and ends the run
+//  Parameters:
+//      where           (input Instruction)     the call, or its Enter
+//      programCounter  (output integer)        set to PROGRAM_HALTED
+static void stackOverflow( const Instruction &where, int &programCounter )
+{
+    cout << "Error: stack overflow";
+    if (where.sourceLine() >= 0)
+        cout << " (line " << where.sourceLine() + 1 << ")";
+    cout << endl;
+    programCounter = PROGRAM_HALTED;
+}
+
+//  The programCounter has already been advanced, so it is the
+//  return address.  A call to a function never defined gives 0.
+//  Exactly as many arguments are pushed as the function takes, so
+//  its frame is the size Enter and Return expect.
+//  The stack grows down, toward stack[0].
+void Call::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    if (entry < 0)
+    {
+        cout << "Error: call to a function that is not defined";
+        if (line >= 0)
+            cout << " (line " << line + 1 << ")";
+        cout << endl;
+        regs[valueTemp] = 0;
+        return;
+    }
+    if (stackPointer < saved + 3 + params)
+    {
+        stackOverflow(*this, programCounter);
+        return;
+    }
+    for (int i = 0; i < saved; ++i)
+        stack[--stackPointer] = regs[i];
+    stack[--stackPointer] = saved;
+    stack[--stackPointer] = valueTemp;
+    stack[--stackPointer] = programCounter;
+
+    stackPointer -= params;
+    for (int i = 0; i < params; ++i)
+        stack[stackPointer + i] = i < (int) args.size() ? regs[args[i]] : 0;
+    programCounter = entry;
+}
+
+string Enter::toString() const
+{
+    stringstream ss;
+    ss << "enter " << params << " + " << locals << endl;
+    return ss.str();
+}
+
+//  Moves the arguments down to make room for the locals above them
+//  (below the return address), and starts each local at 0
+void Enter::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    if (locals == 0)
+        return;
+    if (stackPointer < locals)
+    {
+        stackOverflow(*this, programCounter);
+        return;
+    }
+    for (int i = 0; i < params; ++i)
+        stack[stackPointer - locals + i] = stack[stackPointer + i];
+    stackPointer -= locals;
+    for (int i = params; i < params + locals; ++i)
+        stack[stackPointer + i] = 0;
+}
+
+string Return::toString() const
+{
+    stringstream ss;
+    ss << "return T" << valueTemp << endl;
+    return ss.str();
+}
+
+void Return::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    Integer result = regs[valueTemp];
+    stackPointer += frameSize;
+    programCounter = toInt(stack[stackPointer++]);
+    int resultReg  = toInt(stack[stackPointer++]);
+    int saved      = toInt(stack[stackPointer++]);
+    for (int i = saved - 1; i >= 0; --i)
+        regs[i] = stack[stackPointer++];
+    regs[resultReg] = result;
+}
+
+string FrameLoad::toString() const
+{
+    stringstream ss;
+    ss << "T" << valueTemp << " = frame[" << offset << "]" << endl;
+    return ss.str();
+}
+
+void FrameLoad::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    regs[valueTemp] = stack[stackPointer + offset];
+}
+
+string FrameStore::toString() const
+{
+    stringstream ss;
+    ss << "frame[" << offset << "] = T" << valueTemp << endl;
+    return ss.str();
+}
+
+void FrameStore::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    stack[stackPointer + offset] = regs[valueTemp];
+}
+
+string AddImmToStack::toString() const
+{
+    stringstream ss;
+    ss << "stack[" << toLoc << "] = T" << valueTemp << " = stack[" << fromLoc
+       << "] + " << imm << endl;
+    return ss.str();
+}
+
+void AddImmToStack::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    computeArithmetic('+', stack[fromLoc], imm, regs[valueTemp], *this);
+    stack[toLoc] = regs[valueTemp];
+}
+
+//  The two-character relational operators are given letters of their own
+ComputeStackStack::ComputeStackStack(int result, int a, int b, const string &_oper) :
+    Instruction(result), locA(a), locB(b), oper(_oper)
+{
+    if (oper == "<=")
+        op = 'L';
+    else if (oper == ">=")
+        op = 'G';
+    else if (oper == "==")
+        op = '=';
+    else if (oper == "!=")
+        op = '!';
+    else
+        op = oper[0];
+}
+
+string ComputeStackStack::toString() const
+{
+    stringstream ss;
+    ss << "T" << valueTemp << " = stack[" << locA << "] " << oper << " stack[" << locB << "]" << endl;
+    return ss.str();
+}
+
+void ComputeStackStack::execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const
+{
+    const Integer &a = stack[locA], &b = stack[locB];
+    switch (op)
+    {
+    case '<':   regs[valueTemp] = a < b;    break;
+    case '>':   regs[valueTemp] = a > b;    break;
+    case 'L':   regs[valueTemp] = a <= b;   break;
+    case 'G':   regs[valueTemp] = a >= b;   break;
+    case '=':   regs[valueTemp] = a == b;   break;
+    case '!':   regs[valueTemp] = a != b;   break;
+    default:    computeArithmetic(op, a, b, regs[valueTemp], *this);  break;
+    }
 }
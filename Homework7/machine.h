@@ -8,7 +8,7 @@
 //
 // The machine is expected to have a pre-allocated stack space
 // for named variables and an arbitrarily long list of temporary
-// registers, both represented by integer arrays here (to hold values).
+// registers, both represented by arrays of Integer here (see value.h).
 // The machine also has a separate memory area holding all of the
 // instructions defined below.
 //
@@ -16,21 +16,38 @@
 // they cannot be changed -- only displayed and executed.
 
 #include <iostream>
+#include <vector>
+#include <climits>
 using namespace std;
+#include "value.h"
+
+// What an instruction sets the programCounter to, to end the run
+// at once (when there is no room on the stack for a call)
+const int PROGRAM_HALTED = INT_MAX;
 
 class Instruction
 {
    protected:
 	int valueTemp;		// register computed or tested
 				// additional fields defined later
+	int line;		// source line that produced this instruction
 	Instruction( int temp )
 	{
 	    valueTemp = temp;
+	    line = -1;		// not known until the compiler says so
 	}
    public:
+	virtual ~Instruction() { }	// the compiler deletes any it fuses
+	int sourceLine() const { return line; }
+	void setSourceLine( int l ) { line = l; }
+	int temp() const { return valueTemp; }
+	// the instruction this one may continue at, if any, for a pass
+	// that moves instructions to bring up to date (see compile.cpp)
+	virtual int *branchTarget() { return NULL; }
 	friend ostream& operator<<( ostream&, const Instruction & );
 	virtual string toString() const = 0; // facilitates << operator
-	virtual void execute( int regs[], int stack[], int& stackPointer, int& programCounter ) const = 0;
+	virtual void execute( Integer regs[], Integer stack[], int& stackPointer, int& programCounter ) const = 0;
+	virtual string opcode() const = 0;   // instruction class name, for profiling
 };
 
 // here follow all the derived classes defining additional
@@ -42,17 +59,20 @@ class Print: public Instruction
 {
    public:
 	string toString() const;
-	void execute( int regs[], int stack[], int& stackPointer, int& programCounter ) const;
+	void execute( Integer regs[], Integer stack[], int& stackPointer, int& programCounter ) const;
+	string opcode() const { return "Print"; }
 	Print( int temp ) : Instruction(temp) { }
 };
 
 class Val : public Instruction
 {
-    int val;
+    Integer val;
     public:
         string toString() const;
-        void execute(int regs[], int stack[], int& stackPointer, int& programCounter) const;
-        Val(int result, int value) : Instruction(result), val(value) {}
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "Val"; }
+        Val(int result, Integer value) : Instruction(result), val(value) {}
+        Integer value() const { return val; }
 };
 
 class VarAssign : public Instruction
@@ -60,9 +80,11 @@ class VarAssign : public Instruction
     int stackLoc; // location in the stack
     public:
         string toString() const;
-        void execute(int regs[], int stack[], int& stackPointer, int& programCounter) const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "VarAssign"; }
         VarAssign(int fromReg, int loc) : Instruction(fromReg), stackLoc(loc) {} // No real good thing to send
                                                                                  // to instruction, so just pick one
+        int location() const { return stackLoc; }
 };
 
 class VarLoad : public Instruction
@@ -70,8 +92,10 @@ class VarLoad : public Instruction
     int stackLoc; // location in the stack
     public:
         string toString() const;
-        void execute(int regs[], int stack[], int& stackPointer, int& programCounter) const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "VarLoad"; }
         VarLoad(int result, int loc) : Instruction(result), stackLoc(loc) {}
+        int location() const { return stackLoc; }
 };
 
 class Compute : public Instruction
@@ -79,11 +103,15 @@ class Compute : public Instruction
     string oper;
     protected:
         int argA, argB; //registers for operands
+        void arithmetic( char, Integer regs[] ) const;
     public:
         string toString() const;
-        virtual void execute(int regs[], int stack[], int& stackPointer, int& programCounter) const = 0;
+        virtual void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const = 0;
         Compute (int _result, int _argA, int _argB, string _oper) :
-            Instruction(_result), argA(_argA), argB(_argB), oper(_oper) {}
+            Instruction(_result), oper(_oper), argA(_argA), argB(_argB) {}
+        const string& operation() const { return oper; }
+        int left() const { return argA; }
+        int right() const { return argB; }
 };
 
 // also, as was pointed out in the assignment description,
@@ -96,7 +124,8 @@ class Compute : public Instruction
 class Add: public Compute
 {
    public:
-    void execute( int [], int [], int &, int & ) const;
+    void execute( Integer [], Integer [], int &, int & ) const;
+    string opcode() const { return "Add"; }
     Add( int result, int argA, int argB ) : 
 		Compute(result, argA, argB, "+" ) {}
 };
@@ -104,7 +133,8 @@ class Add: public Compute
 class Subtract: public Compute
 {
    public:
-	void execute( int [], int [], int &, int & ) const;
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "Subtract"; }
 	Subtract( int result, int argA, int argB ) : 
 		Compute(result, argA, argB, "-" ) { }
 };
@@ -112,7 +142,8 @@ class Subtract: public Compute
 class Multiply: public Compute
 {
    public:
-	void execute( int [], int [], int &, int & ) const;
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "Multiply"; }
 	Multiply( int result, int argA, int argB ) : 
 		Compute(result, argA, argB, "*" ) { }
 };
@@ -120,7 +151,8 @@ class Multiply: public Compute
 class Divide: public Compute
 {
    public:
-	void execute( int [], int [], int &, int & ) const;
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "Divide"; }
 	Divide( int result, int argA, int argB ) : 
 		Compute(result, argA, argB, "/" ) { }
 };
@@ -128,9 +160,217 @@ class Divide: public Compute
 class Mod: public Compute
 {
    public:
-	void execute( int [], int [], int &, int & ) const;
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "Mod"; }
 	Mod( int result, int argA, int argB ) : 
 		Compute(result, argA, argB, "%" ) { }
 };
 
+// The relational operators produce 1 for true and 0 for false
+
+class Less: public Compute
+{
+   public:
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "Less"; }
+	Less( int result, int argA, int argB ) :
+		Compute(result, argA, argB, "<" ) { }
+};
+
+class Greater: public Compute
+{
+   public:
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "Greater"; }
+	Greater( int result, int argA, int argB ) :
+		Compute(result, argA, argB, ">" ) { }
+};
+
+class LessEqual: public Compute
+{
+   public:
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "LessEqual"; }
+	LessEqual( int result, int argA, int argB ) :
+		Compute(result, argA, argB, "<=" ) { }
+};
+
+class GreaterEqual: public Compute
+{
+   public:
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "GreaterEqual"; }
+	GreaterEqual( int result, int argA, int argB ) :
+		Compute(result, argA, argB, ">=" ) { }
+};
+
+class Equal: public Compute
+{
+   public:
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "Equal"; }
+	Equal( int result, int argA, int argB ) :
+		Compute(result, argA, argB, "==" ) { }
+};
+
+class NotEqual: public Compute
+{
+   public:
+	void execute( Integer [], Integer [], int &, int & ) const;
+	string opcode() const { return "NotEqual"; }
+	NotEqual( int result, int argA, int argB ) :
+		Compute(result, argA, argB, "!=" ) { }
+};
+
+// Copies one register to another, as when both arms of a
+// conditional must leave their value in the same place
+class Move : public Instruction
+{
+    int fromReg;
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "Move"; }
+        Move(int result, int from) : Instruction(result), fromReg(from) {}
+};
+
+// Continues execution at another instruction
+class Jump : public Instruction
+{
+    int target;
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "Jump"; }
+        Jump(int to) : Instruction(0), target(to) {}
+        int *branchTarget() { return &target; }
+};
+
+// Continues execution at another instruction if a register is zero
+class BranchFalse : public Instruction
+{
+    int target;
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "BranchFalse"; }
+        BranchFalse(int test, int to) : Instruction(test), target(to) {}
+        int *branchTarget() { return &target; }
+};
+
+// Function calls
+// The stack grows downward from the stackPointer, below the named
+// variables of the main program.  A call pushes, in order:
+//     the caller's temporary registers in use (which the function
+//         may then use for itself), and how many of them there are
+//     the register to receive the result
+//     the return address
+//     the arguments, which become the first slots of the new frame
+// The function's first instruction (Enter) makes room in the frame
+// for its other local variables, and its last (Return) pops the
+// whole frame, restores the caller's registers, and delivers the
+// result.  While a function runs, its frame begins at stackPointer,
+// so FrameLoad and FrameStore need only an offset from there.
+
+class Call : public Instruction
+{
+    int entry;              // first instruction of the function,
+                            // or -1 if it was never defined
+    vector<int> args;       // registers holding the arguments
+    int params;             // arguments the function takes: any missing
+                            // are given as 0, and any extra are dropped
+    int saved;              // how many registers to preserve
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "Call"; }
+        Call(int result, int start, const vector<int> &argRegs, int paramCount, int inUse) :
+            Instruction(result), entry(start), args(argRegs), params(paramCount), saved(inUse) {}
+        void setEntry(int start, int paramCount)      // once the function is compiled
+        {
+            entry = start;
+            params = paramCount;
+        }
+        int *branchTarget() { return &entry; }
+};
+
+class Enter : public Instruction
+{
+    int params;             // arguments already in the frame
+    int locals;             // other variables to make room for
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "Enter"; }
+        Enter(int paramCount, int localCount) :
+            Instruction(0), params(paramCount), locals(localCount) {}
+};
+
+class Return : public Instruction
+{
+    int frameSize;          // parameters and locals to pop
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "Return"; }
+        Return(int result, int frame) : Instruction(result), frameSize(frame) {}
+};
+
+class FrameLoad : public Instruction
+{
+    int offset;             // location in the current frame
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "FrameLoad"; }
+        FrameLoad(int result, int slot) : Instruction(result), offset(slot) {}
+};
+
+class FrameStore : public Instruction
+{
+    int offset;             // location in the current frame
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "FrameStore"; }
+        FrameStore(int fromReg, int slot) : Instruction(fromReg), offset(slot) {}
+};
+
+// Superinstructions
+// Each of these does the work of a short sequence of the instructions
+// above that the compiler produces over and over, in a single dispatch
+// (see fuseSequences in compile.cpp).  The temporary registers the
+// sequence used only within itself are never written.
+
+// Adds a constant to a variable, and assigns the sum to a variable
+// (often the same one), standing for
+//     VarLoad Ta;  Val Tb;  Add Tc = Ta + Tb;  VarAssign Tc
+// The sum is left in Tc as well, as the assignment's value.
+class AddImmToStack : public Instruction
+{
+    int fromLoc, toLoc;     // locations in the stack
+    Integer imm;            // the constant
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "AddImmToStack"; }
+        AddImmToStack(int result, int from, Integer constant, int to) :
+            Instruction(result), fromLoc(from), toLoc(to), imm(constant) {}
+};
+
+// Computes from two variables, standing for
+//     VarLoad Ta;  VarLoad Tb;  Tc = Ta op Tb
+// for any of the operators of Compute
+class ComputeStackStack : public Instruction
+{
+    int locA, locB;         // locations in the stack
+    string oper;
+    char op;                // the operator as one character (see machine.cpp)
+    public:
+        string toString() const;
+        void execute(Integer regs[], Integer stack[], int& stackPointer, int& programCounter) const;
+        string opcode() const { return "ComputeStackStack"; }
+        ComputeStackStack(int result, int a, int b, const string &_oper);
+};
+
 #endif
@@ -0,0 +1,190 @@
+// Machine Profiler Implementation File
+// Collects execution counts and tick samples for every instruction,
+// and prints them as an annotated program listing, followed by
+// totals for each kind of instruction and for each source line.
+// The per-line totals may also be dumped as CSV or JSON.
+
+#include <iostream>
+#include <iomanip>
+#include <map>
+using namespace std;
+
+#include "profile.h"
+
+Profiler::Profiler( int codeSize )
+{
+    size = codeSize;
+    counts = new long long[size];
+    cycles = new unsigned long long[size];
+    for (int i = 0; i < size; ++i)
+    {
+        counts[i] = 0;
+        cycles[i] = 0;
+    }
+}
+
+Profiler::~Profiler()
+{
+    delete [] counts;
+    delete [] cycles;
+}
+
+// percent
+// Helper to describe part of a total as a percentage
+static double percent( unsigned long long part, unsigned long long total )
+{
+    return total == 0 ? 0.0 : 100.0 * part / total;
+}
+
+//  report
+//  Prints the profile for the program that was just executed
+//  Parameters:
+//      stream  (modified output stream)    where to write the report
+//      prog    (input Inst array)          the program that was run
+//      progEnd (input integer)             first unused spot in prog
+//      lines   (input string vector)       the source lines that were compiled
+void Profiler::report( ostream &stream, Instruction *prog[], int progEnd,
+        const vector<string> &lines ) const
+{
+    long long totalCount = 0;
+    unsigned long long totalTicks = 0;
+    for (int i = 0; i < progEnd; ++i)
+    {
+        totalCount += counts[i];
+        totalTicks += cycles[i];
+    }
+
+    stream << "Profile: " << totalCount << " instructions executed, "
+           << totalTicks << " ticks" << endl << endl;
+
+    // The same listing as before the run, with the measurements beside it
+    stream << " pc       count       ticks   tick%  instruction" << endl;
+    for (int i = 0; i < progEnd; ++i)
+    {
+        stream << setw(3) << i << ": " << setw(10) << counts[i]
+               << setw(12) << cycles[i] << setw(7) << fixed << setprecision(1)
+               << percent(cycles[i], totalTicks) << "%  " << *prog[i];
+    }
+    stream << endl;
+
+    // Totals for each kind of instruction
+    map<string, long long> opCounts;
+    map<string, unsigned long long> opTicks;
+    for (int i = 0; i < progEnd; ++i)
+    {
+        opCounts[prog[i]->opcode()] += counts[i];
+        opTicks[prog[i]->opcode()] += cycles[i];
+    }
+
+    stream << "By opcode:" << endl;
+    for (map<string, long long>::iterator iter = opCounts.begin(); iter != opCounts.end(); ++iter)
+    {
+        stream << "  " << left << setw(12) << iter->first << right
+               << setw(10) << iter->second << setw(12) << opTicks[iter->first]
+               << setw(7) << percent(opTicks[iter->first], totalTicks) << "%" << endl;
+    }
+    stream << endl;
+
+    // Totals for each source line
+    vector<long long> lineCounts(lines.size(), 0);
+    vector<unsigned long long> lineTicks(lines.size(), 0);
+    for (int i = 0; i < progEnd; ++i)
+    {
+        int line = prog[i]->sourceLine();
+        if (line >= 0 && line < (int)lines.size())
+        {
+            lineCounts[line] += counts[i];
+            lineTicks[line] += cycles[i];
+        }
+    }
+
+    stream << "By source line:" << endl;
+    for (unsigned l = 0; l < lines.size(); ++l)
+    {
+        stream << setw(5) << l + 1 << ": " << setw(10) << lineCounts[l]
+               << setw(12) << lineTicks[l] << setw(7)
+               << percent(lineTicks[l], totalTicks) << "%  " << lines[l] << endl;
+    }
+    stream << endl;
+
+    stream.unsetf(ios::fixed);
+}
+
+// quoted
+// Helper to write a source line as a quoted CSV or JSON string
+static void quoted( ostream &stream, const string &text, bool json )
+{
+    stream << '"';
+    for (unsigned i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == '"')
+            stream << (json ? "\\\"" : "\"\"");
+        else if (json && text[i] == '\\')
+            stream << "\\\\";
+        else
+            stream << text[i];
+    }
+    stream << '"';
+}
+
+//  dumpLines
+//  Writes compile and execution measurements for every source line,
+//  in a form other programs can read (CSV, or JSON if json is set).
+//  Parameters:
+//      stream  (modified output stream)    where to write the dump
+//      json    (input boolean)             JSON instead of CSV
+//      prog    (input Inst array)          the program that was run
+//      progEnd (input integer)             first unused spot in prog
+//      lines   (input string vector)       the source lines that were compiled
+//      times   (input CompileTimes vector) compile times for each line
+void Profiler::dumpLines( ostream &stream, bool json, Instruction *prog[], int progEnd,
+        const vector<string> &lines, const vector<CompileTimes> &times ) const
+{
+    vector<int> lineInstructions(lines.size(), 0);
+    vector<long long> lineCounts(lines.size(), 0);
+    vector<unsigned long long> lineTicks(lines.size(), 0);
+    for (int i = 0; i < progEnd; ++i)
+    {
+        int line = prog[i]->sourceLine();
+        if (line >= 0 && line < (int)lines.size())
+        {
+            lineInstructions[line]++;
+            lineCounts[line] += counts[i];
+            lineTicks[line] += cycles[i];
+        }
+    }
+
+    if (json)
+        stream << "[" << endl;
+    else
+        stream << "line,tokenize_ticks,parse_ticks,codegen_ticks,"
+               << "instructions,executed,execute_ticks,source" << endl;
+
+    for (unsigned l = 0; l < lines.size(); ++l)
+    {
+        if (json)
+        {
+            stream << "  {\"line\": " << l + 1
+                   << ", \"tokenize_ticks\": " << times[l].tokenize
+                   << ", \"parse_ticks\": " << times[l].parse
+                   << ", \"codegen_ticks\": " << times[l].codegen
+                   << ", \"instructions\": " << lineInstructions[l]
+                   << ", \"executed\": " << lineCounts[l]
+                   << ", \"execute_ticks\": " << lineTicks[l]
+                   << ", \"source\": ";
+            quoted(stream, lines[l], true);
+            stream << (l + 1 < lines.size() ? "}," : "}") << endl;
+        }
+        else
+        {
+            stream << l + 1 << "," << times[l].tokenize << "," << times[l].parse
+                   << "," << times[l].codegen << "," << lineInstructions[l]
+                   << "," << lineCounts[l] << "," << lineTicks[l] << ",";
+            quoted(stream, lines[l], false);
+            stream << endl;
+        }
+    }
+
+    if (json)
+        stream << "]" << endl;
+}
@@ -0,0 +1,47 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+// Machine Profiler
+// This records how often each instruction in the program memory
+// is executed, and roughly how long each one takes, so that the
+// hot instructions (and the source lines that produced them)
+// can be identified after a run.
+//
+// Timing uses the tick counter described in timer.h.
+
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "timer.h"
+#include "machine.h"
+#include "compile.h"
+
+class Profiler
+{
+    private:
+        long long *counts;              // executions per program counter
+        unsigned long long *cycles;     // ticks spent per program counter
+        int size;                       // number of program counters tracked
+    public:
+        Profiler( int codeSize );
+        ~Profiler();
+
+        // record
+        // Notes one execution of the instruction at pc
+        void record( int pc, unsigned long long elapsed )
+        {
+            counts[pc]++;
+            cycles[pc] += elapsed;
+        }
+
+        long long count( int pc ) const { return counts[pc]; }
+        unsigned long long ticks( int pc ) const { return cycles[pc]; }
+
+        void report( ostream&, Instruction *prog[], int progEnd,
+                const vector<string> &lines ) const;
+        void dumpLines( ostream&, bool json, Instruction *prog[], int progEnd,
+                const vector<string> &lines, const vector<CompileTimes> &times ) const;
+};
+
+#endif
@@ -0,0 +1,50 @@
+// Result Sink Implementation File
+// The parts of the sinks that are not simple enough for the header,
+// and the standard output sink that results go to unless the driver
+// chooses another.
+
+#include <iostream>
+#include <climits>
+#include <unistd.h>
+using namespace std;
+
+#include "sink.h"
+
+//  The bits of a value, if it fits in a long long at all
+static bool toLongLong( const Integer &value, long long &result )
+{
+#if defined(VALUE_BIGNUM)
+    if (!value.isSmall())
+        return false;
+    result = value.toLongLong();
+#else
+    result = value;
+#endif
+    return true;
+}
+
+//  A value too wide for the format is not written; the reader would
+//  only be misled by part of it
+void BinarySink::put( const Integer &value )
+{
+    long long v;
+    if (!toLongLong( value, v ) || (bytes == 4 && (v < INT_MIN || v > INT_MAX)))
+    {
+        cout << "Error: " << value << " does not fit in " << bytes * 8
+             << " bits" << endl;
+        return;
+    }
+    unsigned long long bits = v;
+    char little[8];
+    for (int i = 0; i < bytes; ++i)
+        little[i] = (char) (bits >> (8 * i));
+    out.write( little, bytes );
+}
+
+bool isInteractive( const ostream &stream )
+{
+    return &stream == &cout && isatty( STDOUT_FILENO );
+}
+
+static TextSink standardOutput( cout, isInteractive( cout ) );
+ResultSink *resultSink = &standardOutput;
@@ -0,0 +1,74 @@
+#ifndef SINK_H
+#define SINK_H
+// Result Sink Header File
+// Where the machine's Print instruction (and dc's p) sends each result.
+// The results used to be written to cout with endl, which flushes
+// the stream every time -- a system call for every number printed,
+// which is what the time went to when millions were written to a
+// file or a pipe.  A sink instead says exactly when to flush:
+//     TextSink        each result as a line of text, flushed at once
+//                     only when someone is watching (a terminal)
+//     BinarySink      each result as a 32- or 64-bit little-endian
+//                     integer, for another program to read
+//     CollectorSink   keeps the results in memory, for a program that
+//                     embeds the machine and wants them back
+// Every sink is also flushed when a run is over (see driver.cpp).
+
+#include <iostream>
+#include <vector>
+using namespace std;
+#include "value.h"
+
+class ResultSink
+{
+    public:
+        virtual ~ResultSink() { }
+        virtual void put( const Integer &value ) = 0;  // one result
+        virtual void flush() { }                        // send on any held back
+};
+
+class TextSink : public ResultSink
+{
+    private:
+        ostream &out;
+        bool interactive;       // flush after every result
+    public:
+        TextSink( ostream &o, bool flushEach ) : out( o ), interactive( flushEach ) { }
+        void put( const Integer &value )
+        {
+            out << value << '\n';
+            if (interactive)
+                out.flush();
+        }
+        void flush() { out.flush(); }
+};
+
+class BinarySink : public ResultSink
+{
+    private:
+        ostream &out;
+        int bytes;              // 4 or 8
+    public:
+        BinarySink( ostream &o, int bits ) : out( o ), bytes( bits / 8 ) { }
+        void put( const Integer &value );
+        void flush() { out.flush(); }
+};
+
+class CollectorSink : public ResultSink
+{
+    private:
+        vector<Integer> values;
+    public:
+        void put( const Integer &value ) { values.push_back( value ); }
+        const vector<Integer>& results() const { return values; }
+        void clear() { values.clear(); }
+};
+
+// isInteractive
+// Whether a stream is the standard output, and that is a terminal
+bool isInteractive( const ostream &stream );
+
+// The sink every result goes to; at first, a TextSink on cout
+extern ResultSink *resultSink;
+
+#endif
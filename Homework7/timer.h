@@ -0,0 +1,30 @@
+#ifndef TIMER_H
+#define TIMER_H
+// Interval Timer
+// A cheap tick counter for measuring short intervals, such as
+// the execution of one instruction or the compilation of one line.
+//
+// Ticks come from the processor's time stamp counter where it is
+// available, and from the monotonic clock (in nanoseconds) elsewhere.
+// Only differences between two readings are meaningful.
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+// readCycles
+// Returns the current tick count
+inline unsigned long long readCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+#endif
@@ -15,13 +15,14 @@
 #include <stdlib.h>
 #include <ctype.h>
 using namespace std;
+#include "value.h"
  
 // Here is a definition of the token itself:
 class Token {
     //  All the data members are private to keep them protected.
     private:
     bool    isInt;        // to identify the token type later
-    int    value;        // value for an integer token
+    Integer value;       // value for an integer token
     string    text;        // character for an operator token
 
     //  All of the methods here are public (which is not always the case)
@@ -40,7 +41,7 @@ class Token {
         isInt = false;
         value = 0;        // initialize unused value
     }
-    Token(int i)        // integer value
+    Token(Integer i)    // integer value
     {        
         value = i;
         isInt = true;
@@ -72,7 +73,7 @@ class Token {
         return isInt;
     }
 
-    int integerValue() const
+    Integer integerValue() const
     {
         return value;
     }
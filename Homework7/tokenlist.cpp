@@ -8,72 +8,95 @@
 #include <string.h>
 #include <ctype.h>
 
+// A table classifying every character, and fast ways to skip blanks and letters
+#include "scanner.h"
+
 // And to get the definition of a token:
 #include "tokenlist.h"
+#include "alloctrack.h"
 
 bool isOperator(char c);
 
-// TokenList constructor
-// converts a character string into a list of tokens
-// Parameter:
-//     expr    (input char pointer)    // string to examine
-// Pre-condition:  str may not be a null pointer
-//     and is assumed to actually point at a valid expression.
-TokenList::TokenList( const char expr[])
+// scanToken
+// Scans one token, classifying each character with one table lookup
+// (see scanner.h), and converting numbers in the same pass that finds them.
+// Parameters:
+//     position (input char pointer)   start of the token, not a blank or the end
+//     t        (output Token)         the token found there
+// Returns:
+//     the first character after the token
+const char *scanToken( const char *position, Token &t )
 {
- 
-    tail = NULL;
-    head = NULL;
-
-    int position = 0;
-    
-    //Go past any initial spaces
-    while (expr[position] == ' ')
-        ++position;
-
-    //Go until we hit a null character
-    while (expr[position] != '\0')
+    switch (classOf(*position))
     {
-        if (isdigit(expr[position]))
+    case CHAR_DIGIT:
         {
-            Token t(atoi(&expr[position]));
-            push_back(t);
-            while (isdigit(expr[position]))
-                ++position;
+            //The value is built up as the digits go by, rather than rescanning them
+            Integer value = 0;
+            do
+                value = value * 10 + (*position++ - '0');
+            while (classOf(*position) == CHAR_DIGIT);
+            t = Token(value);
         }
-        else if (isOperator(expr[position]))
+        break;
+
+    case CHAR_OPER:
         {
-            string charstring;
-            charstring += expr[position];
-            ++position;
+            const char *start = position++;
 
             //This next bit will take care of 2 character operations (>=, <=, !=, ==)
             //I have this rather than a while loop to keep the program from swallowing long strings
             //of operators, such as in A=(B+C), where =( would be treated as one operator.
-            if (expr[position] == '=' && expr[position - 1] != ')')
-            {
-                charstring += expr[position];
+            if (*position == '=' && *start != ')')
                 ++position;
-            }
 
-            Token t(charstring);
-            push_back(t);
+            t = Token(string(start, position - start));
         }
-        else
+        break;
+
+    default:
         {
-            string charstring;
-            while (expr[position] != ' ' && expr[position] != '\0' && !isOperator(expr[position]))
+            //A name runs up to the next space, operator or the end, and may contain digits
+            const char *start = position;
+            for (;;)
             {
-                charstring += expr[position];
+                position = skipLetters(position);
+                int next = classOf(*position);
+                if (next != CHAR_NAME && next != CHAR_DIGIT)
+                    break;
                 ++position;
             }
-            Token t(charstring);
-            push_back(t);
+            t = Token(string(start, position - start));
         }
+    }
+    return position;
+}
+
+// TokenList constructor
+// converts a character string into a list of tokens
+// Parameter:
+//     expr    (input char pointer)    // string to examine
+// Pre-condition:  str may not be a null pointer
+//     and is assumed to actually point at a valid expression.
+TokenList::TokenList( const char expr[])
+{
+    ALLOC_SCOPE( ALLOC_TOKENIZER );
+
+    tail = NULL;
+    head = NULL;
+
+    //Go past any initial spaces
+    const char *position = skipBlanks(expr);
+
+    //Go until we hit a null character
+    while (*position != '\0')
+    {
+        Token t;
+        position = scanToken(position, t);
+        push_back(t);
 
         //Advance to next token if we're on spaces
-        while (expr[position] == ' ')
-            ++position;
+        position = skipBlanks(position);
     }
 }
 
@@ -86,9 +109,7 @@ TokenList::TokenList( const char expr[])
 //     (bool) - whether or not the character is recognized as an operator
 bool isOperator(char c)
 {
-    return (c == '+' || c == '-' || c == '*' || c == '/' || c == '%' || 
-            c == '(' || c == ')' || c == '=' || c == ',' || c == '<' ||
-            c == '>' || c == '!' || c == '?' || c == ':');
+    return classOf(c) == CHAR_OPER;
 }
 
 //  output operation
@@ -118,8 +139,9 @@ ListIterator TokenList::end()
 //  Add a new element to the back of the list
 //  Parameter:
 //       t    (input Token)    the new item to add
-void TokenList::push_back(Token t)
+void TokenList::push_back(const Token& t)
 {
+    ALLOC_SCOPE( ALLOC_TOKENIZER );
     ListElement* newElement = new ListElement();
     newElement->token = t;
     newElement->next = NULL;
@@ -140,8 +162,9 @@ void TokenList::push_back(Token t)
 //  Add a new element to the front of the list
 //  Parameter:
 //       t    (input Token)    the new item to add
-void TokenList::push_front(Token t)
+void TokenList::push_front(const Token& t)
 {
+    ALLOC_SCOPE( ALLOC_TOKENIZER );
     ListElement* newElement = new ListElement();
     newElement->token = t;
     newElement->next = head;
@@ -1,3 +1,5 @@
+#ifndef TOKENLIST_H
+#define TOKENLIST_H
 // Token List Header file
 // This is a linked list for use with the tokens for an
 // arithmetic expression.  Although it is used for that
@@ -20,6 +22,12 @@ struct ListElement {
 
 class ListIterator;            // class definition later
 
+// scanToken
+// Scans the one token starting at the given character (which
+// must not be a blank or the end), returning where it ends.
+// Shared by the TokenList constructor and the Lexer.
+const char *scanToken( const char *position, Token &t );
+
 class TokenList  {
     friend class ListIterator;
     friend ostream& operator<<( ostream &, TokenList &);
@@ -53,8 +61,8 @@ class TokenList  {
         return head->token;
     }
 
-    void push_back( Token t );
-    void push_front( Token t );
+    void push_back( const Token& t );
+    void push_front( const Token& t );
     Token pop_front();
 
     // and now some support for the List Iterator
@@ -89,7 +97,7 @@ class ListIterator
     {
         return curr->token.isInteger();
     }
-    int integerValue()
+    Integer integerValue()
     {
         return curr->token.integerValue();
     }
@@ -103,5 +111,5 @@ class ListIterator
         return list != other.list || curr != other.curr;
     }
 };
-    
 
+#endif
@@ -0,0 +1,49 @@
+#ifndef VALUE_H
+#define VALUE_H
+// Integer Value Header File
+// Chooses the one type of integer that every value in this program is
+// held as: the numbers read, the variables, the results of evaluating
+// a tree, and the registers and stack of the machine.
+//     (by default)    int, as the assignment describes
+//     -DVALUE_INT64   long long, 64 bits
+//     -DVALUE_BIGNUM  BigInt, of any size at all (see bigint.h)
+// Each wider choice costs something everywhere; the benchmarks are
+// built all three ways (see bench/Makefile) to show how much.
+
+#include <iostream>
+using namespace std;
+
+#if defined(VALUE_BIGNUM)
+#include "bigint.h"
+typedef BigInt Integer;
+#elif defined(VALUE_INT64)
+typedef long long Integer;
+#else
+typedef int Integer;
+#endif
+
+// toInt
+// Recovers a small bookkeeping number kept as a value, such as
+// the stack location the compiler records for a variable
+inline int toInt( const Integer &i )
+{
+#if defined(VALUE_BIGNUM)
+    return (int) i.toLongLong();
+#else
+    return (int) i;
+#endif
+}
+
+// writeMagnitude
+// Writes the absolute value of a number -- even of the most negative
+// int or long long, whose absolute value does not fit in its type
+inline ostream& writeMagnitude( ostream &stream, const Integer &i )
+{
+#if defined(VALUE_BIGNUM)
+    return stream << (i < 0 ? -i : i);
+#else
+    return stream << (i < 0 ? 0ULL - (unsigned long long) i : (unsigned long long) i);
+#endif
+}
+
+#endif
@@ -6,6 +6,7 @@
 using namespace std;
 
 #include "vartree.h"
+#include "alloctrack.h"
 
 //  recursiveSearch
 //  A recursive tree-traversal function to search for a variable.
@@ -43,14 +44,34 @@ TreeNode* VarTree::recursiveSearch( TreeNode *&node, string name )
     return node;        
 }
 
+//  destroy
+//  Deletes every node in a sub-tree
+//  Parameters:
+//      node    (input TreeNode ptr)    root of sub-tree to delete
+void VarTree::destroy( TreeNode *node )
+{
+    if (node != NULL)
+    {
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+}
+
+VarTree::~VarTree()
+{
+    destroy(root);
+}
+
 //  lookup
 //  Searches for a variable to get its value
 //  If the variable does not yet exist, it is created with value 0.
 //  Parameters:
 //      name (input char array) name of variable
 //  Returns:  value of variable
-int VarTree::lookup( string name )
+Integer VarTree::lookup( string name )
 {
+    ALLOC_SCOPE( ALLOC_SYMBOLS );
     TreeNode *node = recursiveSearch( root, name );
     return node->value;
 }
@@ -61,8 +82,9 @@ int VarTree::lookup( string name )
 //  Parameters:
 //      name  (input string)  name of variable
 //      value (input integer) value to assign
-void VarTree::assign( string name, int value )
+void VarTree::assign( string name, Integer value )
 {
+    ALLOC_SCOPE( ALLOC_SYMBOLS );
     TreeNode *node = recursiveSearch( root, name );
     node->value = value;
 }
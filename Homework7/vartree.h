@@ -11,6 +11,7 @@
 #include <iostream>
 #include <string>
 using namespace std;
+#include "value.h"
 
 // A node anywhere in tree
 class TreeNode
@@ -19,12 +20,12 @@ class TreeNode
     friend class VarTree;
     private:
     string    name;        // variable name
-    int    value;        // variable value
+    Integer value;       // variable value
     TreeNode *left,        // sub-tree for less than
          *right;    // sub-tree for greater than
 
     // Private constructor: only for use by VarTree
-    TreeNode( string newName , int val )
+    TreeNode( string newName , Integer val )
     {
         name.assign( newName );    // get the name
         value = val;        // and the value
@@ -45,12 +46,16 @@ class VarTree
         root = NULL;    // empty tree
         count = 0;
     }
-    void assign( string, int );
-    int lookup( string );
+    ~VarTree();
+    void assign( string, Integer );
+    Integer lookup( string );
     int size() { return count; }
 
     private:        // these just help VarTree do its job
     TreeNode* recursiveSearch( TreeNode *&, string );
+    void destroy( TreeNode * );
+    VarTree( const VarTree& );                  // trees are never copied
+    VarTree& operator=( const VarTree& );
 };
 
 #endif
@@ -0,0 +1,186 @@
+// Benchmark Harness Implementation File
+// Runs each registered benchmark with a growing number of iterations
+// until it takes long enough to time reliably, then reports the cost
+// per iteration.  Heap allocations are counted by replacing the
+// global operator new and operator delete.
+//
+// Every benchmark executable links this file, which supplies main():
+//     bench_hwN [filter]
+// runs the benchmarks whose names contain filter (or all of them).
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+using namespace std;
+
+#include "benchmark.h"
+
+static long long allocations = 0;      // calls to operator new
+static long long allocated = 0;        // bytes requested from operator new
+
+void* operator new( size_t size )
+{
+    ++allocations;
+    allocated += size;
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+        throw bad_alloc();
+    return p;
+}
+
+void* operator new[]( size_t size )
+{
+    return operator new(size);
+}
+
+void operator delete( void *p ) noexcept
+{
+    free(p);
+}
+
+void operator delete[]( void *p ) noexcept
+{
+    free(p);
+}
+
+void operator delete( void *p, size_t ) noexcept
+{
+    free(p);
+}
+
+void operator delete[]( void *p, size_t ) noexcept
+{
+    free(p);
+}
+
+namespace bench
+{
+    struct Registered
+    {
+        const char *name;
+        Function fn;
+        long long arg;
+    };
+
+    // Constructed on first use, since benchmarks register themselves
+    // from static initializers in other files.
+    static vector<Registered>& registry()
+    {
+        static vector<Registered> list;
+        return list;
+    }
+
+    int registerBenchmark( const char name[], Function fn, long long arg )
+    {
+        Registered r;
+        r.name = name;
+        r.fn = fn;
+        r.arg = arg;
+        registry().push_back(r);
+        return 0;
+    }
+
+    long long allocationCount() { return allocations; }
+    long long allocationBytes() { return allocated; }
+
+    // seconds
+    // Reads the monotonic clock
+    static double seconds()
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec + now.tv_nsec * 1e-9;
+    }
+
+    // startOrStop
+    // Starts the clock and counters on the first call to keepRunning,
+    // and stops them when the iterations run out
+    bool State::startOrStop()
+    {
+        if (!running)
+        {
+            running = true;
+            allocsAtStart = ::allocations;
+            bytesAtStart = ::allocated;
+            started = seconds();
+            if (remaining > 0)
+            {
+                --remaining;
+                return true;
+            }
+        }
+        elapsed = seconds() - started;
+        allocs = ::allocations - allocsAtStart;
+        bytes = ::allocated - bytesAtStart;
+        return false;
+    }
+
+    const double MIN_TIME = 0.2;           // seconds each benchmark should run
+    const long long MAX_ITERATIONS = 1000000000LL;
+
+    void runBenchmarks( const char filter[] )
+    {
+        cout << left << setw(40) << "Benchmark" << right
+             << setw(14) << "ns/op" << setw(12) << "iterations"
+             << setw(12) << "allocs/op" << setw(12) << "bytes/op"
+             << setw(14) << "items/s" << endl;
+        cout << string(104, '-') << endl;
+
+        for (unsigned i = 0; i < registry().size(); ++i)
+        {
+            Registered &r = registry()[i];
+            if (filter != NULL && strstr(r.name, filter) == NULL)
+                continue;
+
+            long long iterations = 1;
+            double elapsed = 0;
+            long long allocs = 0, bytes = 0, items = 0;
+            while (true)
+            {
+                State state(iterations, r.arg);
+                r.fn(state);
+                elapsed = state.elapsedTime();
+                allocs = state.allocations();
+                bytes = state.allocatedBytes();
+                items = state.itemsPerIteration();
+
+                if (elapsed >= MIN_TIME || iterations >= MAX_ITERATIONS)
+                    break;
+
+                // aim a little past the minimum time, growing at most 10x per try
+                double scale = elapsed > 0 ? MIN_TIME * 1.4 / elapsed : 10;
+                if (scale > 10)
+                    scale = 10;
+                if (scale < 2)
+                    scale = 2;
+                iterations = (long long)(iterations * scale);
+            }
+
+            string label = r.name;
+            if (r.arg != 0)
+            {
+                char argText[32];
+                sprintf(argText, "/%lld", r.arg);
+                label += argText;
+            }
+
+            cout << left << setw(40) << label << right << fixed
+                 << setw(14) << setprecision(1) << elapsed * 1e9 / iterations
+                 << setw(12) << iterations
+                 << setw(12) << setprecision(2) << (double)allocs / iterations
+                 << setw(12) << setprecision(0) << (double)bytes / iterations;
+            if (items > 0)
+                cout << setw(14) << setprecision(0) << items * iterations / elapsed;
+            cout << endl;
+        }
+    }
+}
+
+int main( int argc, char *argv[] )
+{
+    bench::runBenchmarks( argc > 1 ? argv[1] : NULL );
+}
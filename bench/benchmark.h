@@ -0,0 +1,103 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+// Benchmark Harness Header File
+// A very small imitation of Google Benchmark, so that every homework
+// pipeline can be timed the same way without an external library.
+//
+// A benchmark is a function taking a bench::State, which loops while
+// state.keepRunning() is true, timing only the body of that loop:
+//
+//     void BM_Something( bench::State &state )
+//     {
+//         string input = makeInput( state.arg() );    // not timed
+//         while (state.keepRunning())
+//             bench::doNotOptimize( work(input) );    // timed
+//     }
+//     BENCHMARK_ARG( BM_Something, 1000 );
+//
+// The harness picks the iteration count, and reports the time
+// and the number of heap allocations (and bytes) per iteration.
+// Everything lives in namespace bench so as not to collide with
+// the homework code it is linked against.
+
+#include <string>
+
+namespace bench
+{
+    class State
+    {
+        private:
+            long long remaining;    // iterations still to run
+            long long arg0;         // size argument for this run
+            long long items;        // items processed per iteration, if known
+            bool running;           // whether the timed loop has begun
+            double started;         // when it began
+            double elapsed;         // seconds spent in the timed loop
+            long long allocsAtStart, bytesAtStart;  // counters when it began
+            long long allocs, bytes;                // allocated in the loop
+
+            bool startOrStop();
+        public:
+            State( long long iterations, long long arg )
+            {
+                remaining = iterations;
+                arg0 = arg;
+                items = 0;
+                running = false;
+                started = elapsed = 0;
+                allocsAtStart = bytesAtStart = allocs = bytes = 0;
+            }
+            // keepRunning
+            // Only the loop it controls is timed: the clock starts on
+            // the first call and stops on the call that returns false,
+            // so any setup before the loop is not counted.
+            bool keepRunning()
+            {
+                if (running && remaining > 0)
+                {
+                    --remaining;
+                    return true;
+                }
+                return startOrStop();
+            }
+            long long arg() const { return arg0; }
+            void setItemsPerIteration( long long n ) { items = n; }
+            long long itemsPerIteration() const { return items; }
+            double elapsedTime() const { return elapsed; }
+            long long allocations() const { return allocs; }
+            long long allocatedBytes() const { return bytes; }
+    };
+
+    typedef void (*Function)( State & );
+
+    // registerBenchmark
+    // Adds a benchmark to the list run by runBenchmarks
+    // Returns a dummy value so it can initialize a static variable.
+    int registerBenchmark( const char name[], Function fn, long long arg );
+
+    // runBenchmarks
+    // Runs every registered benchmark whose name contains filter
+    // (all of them if filter is NULL), printing one line per benchmark.
+    void runBenchmarks( const char filter[] );
+
+    // allocation counters, maintained by the replacement operator new
+    long long allocationCount();
+    long long allocationBytes();
+
+    // doNotOptimize
+    // Forces a value to be computed even if it is otherwise unused
+    template <class T>
+    inline void doNotOptimize( const T &value )
+    {
+        asm volatile( "" : : "r,m"(value) : "memory" );
+    }
+}
+
+#define BENCH_CONCAT2(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT2(a, b)
+#define BENCHMARK_ARG(fn, arg) \
+    static int BENCH_CONCAT(fn##_registered_, __LINE__) = \
+        bench::registerBenchmark( #fn, fn, arg )
+#define BENCHMARK(fn) BENCHMARK_ARG(fn, 0)
+
+#endif
@@ -0,0 +1,130 @@
+// Synthetic Input Generators Implementation File
+// Builds expressions as text, operand by operand.
+
+#include <sstream>
+using namespace std;
+
+#include "generate.h"
+
+string variableName( int i )
+{
+    ostringstream name;
+    name << "v" << i;
+    return name.str();
+}
+
+// operand
+// Helper to produce a random literal (1 to 99) or variable
+static string operand( Random &random, int variables )
+{
+    ostringstream text;
+    if (variables > 0 && random.next(2) == 0)
+        text << variableName(random.next(variables));
+    else
+        text << 1 + random.next(99);
+    return text.str();
+}
+
+string flatExpression( int terms, int variables, unsigned seed )
+{
+    static const char opers[] = "+-*";
+    Random random(seed);
+    string text = operand(random, variables);
+    for (int i = 1; i < terms; ++i)
+    {
+        text += ' ';
+        text += opers[random.next(3)];
+        text += ' ';
+        text += operand(random, variables);
+    }
+    return text;
+}
+
+string digitExpression( int terms, unsigned seed )
+{
+    static const char opers[] = "+-*";
+    Random random(seed);
+    string text( 1, '1' + random.next(9) );
+    for (int i = 1; i < terms; ++i)
+    {
+        text += ' ';
+        text += opers[random.next(3)];
+        text += ' ';
+        text += '1' + random.next(9);
+    }
+    return text;
+}
+
+string sumExpression( int terms, int variables, unsigned seed )
+{
+    Random random(seed);
+    string text = operand(random, variables);
+    for (int i = 1; i < terms; ++i)
+    {
+        text += random.next(2) == 0 ? " + " : " - ";
+        text += operand(random, variables);
+    }
+    return text;
+}
+
+string nestedExpression( int depth, unsigned seed )
+{
+    static const char opers[] = "+-*";
+    Random random(seed);
+    string text;
+    for (int i = 0; i < depth; ++i)
+    {
+        text += operand(random, 0);
+        text += opers[random.next(3)];
+        text += '(';
+    }
+    text += operand(random, 0);
+    text += string(depth, ')');
+    return text;
+}
+
+// precedence
+// Helper giving the binding strength of the operators generated
+static int precedence( char oper )
+{
+    return oper == '*' ? 2 : oper == 0 ? 3 : 1;
+}
+
+// randomSubtree
+// Recursive helper for randomExpression
+// Parameters:
+//	terms	(input integer)		operands in this subtree
+//	depth	(input integer)		nesting still allowed
+//	oper	(output character)	operator at the root (0 for an operand)
+static string randomSubtree( Random &random, int terms, int depth,
+        int variables, char &oper )
+{
+    static const char opers[] = "+-*";
+    if (terms <= 1 || depth <= 0)
+    {
+        oper = 0;
+        return operand(random, variables);
+    }
+
+    oper = opers[random.next(3)];
+    int leftTerms = 1 + random.next(terms - 1);
+    char leftOper, rightOper;
+    string left = randomSubtree(random, leftTerms, depth - 1, variables, leftOper);
+    string right = randomSubtree(random, terms - leftTerms, depth - 1, variables, rightOper);
+
+    // left operand needs parentheses if it binds more loosely;
+    // right operand also needs them when it binds equally (a - (b - c))
+    if (precedence(leftOper) < precedence(oper))
+        left = "(" + left + ")";
+    if (precedence(rightOper) <= precedence(oper))
+        right = "(" + right + ")";
+
+    return left + oper + right;
+}
+
+string randomExpression( int terms, int maxDepth, int variables, unsigned seed )
+{
+    Random random(seed);
+    char oper;
+    return randomSubtree(random, terms, maxDepth, variables, oper);
+}
@@ -0,0 +1,71 @@
+#ifndef GENERATE_H
+#define GENERATE_H
+// Synthetic Input Generators
+// These build expressions in the grammar shared by the homeworks,
+// with a controllable size, nesting depth and number of variables,
+// so the benchmarks can measure how each pipeline scales.
+//
+// All generators are deterministic: the same arguments (and seed)
+// always produce the same text.
+
+#include <string>
+using namespace std;
+
+// A small linear congruential generator, so that results do not
+// depend on the platform's rand()
+class Random
+{
+    private:
+        unsigned long long state;
+    public:
+        Random( unsigned long long seed )
+        {
+            state = seed * 2862933555777941757ULL + 3037000493ULL;
+        }
+        // next
+        // Returns a number from 0 to n-1
+        int next( int n )
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return (int)((state >> 33) % (unsigned long long)n);
+        }
+};
+
+// variableName
+// The name used for the i'th generated variable ("v0", "v1", ...)
+string variableName( int i );
+
+// flatExpression
+// A long expression with no parentheses, like "3 + v1 * 7 - 2 ..."
+// Parameters:
+//	terms		(input integer)	number of operands
+//	variables	(input integer)	how many distinct variables to use
+//					(0 for literal numbers only)
+//	seed		(input integer)	random seed
+string flatExpression( int terms, int variables, unsigned seed );
+
+// digitExpression
+// A flat expression of single digits (1 to 9), as Homework 1 accepts,
+// like "3 + 1 * 7 - 2 ..."
+string digitExpression( int terms, unsigned seed );
+
+// sumExpression
+// A flat expression of additions and subtractions only, so that with
+// a few thousand operands its value never overflows even an int
+string sumExpression( int terms, int variables, unsigned seed );
+
+// nestedExpression
+// An expression nested depth parentheses deep, like "(1+(2*(3-...)))"
+string nestedExpression( int depth, unsigned seed );
+
+// randomExpression
+// A randomly shaped expression with about the given number of
+// operands, using + - * and parentheses only where they are needed.
+// Parameters:
+//	terms		(input integer)	number of operands
+//	maxDepth	(input integer)	deepest nesting of operators allowed
+//	variables	(input integer)	how many distinct variables to use
+//	seed		(input integer)	random seed
+string randomExpression( int terms, int maxDepth, int variables, unsigned seed );
+
+#endif
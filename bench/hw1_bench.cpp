@@ -0,0 +1,39 @@
+// Homework 1 Benchmarks
+// Times the Homework 1 evaluator, which works directly on the
+// characters of an expression, against the one it replaced.
+
+#include <iostream>
+#include <string>
+using namespace std;
+
+#include "benchmark.h"
+#include "generate.h"
+
+#include "evaluate.h"
+
+// the old evaluator, from legacy_evaluate1.cpp
+int legacyEvaluate( const char expression[] );
+
+// evaluate on a flat expression of arg() single digits
+void BM_Evaluate( bench::State &state )
+{
+    string expr = digitExpression(state.arg(), 1);
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        bench::doNotOptimize(evaluate(expr.c_str()));
+}
+BENCHMARK_ARG( BM_Evaluate, 10 );
+BENCHMARK_ARG( BM_Evaluate, 10000 );
+BENCHMARK_ARG( BM_Evaluate, 1000000 );
+
+// The recursive evaluator it replaced, on the same input
+void BM_EvaluateLegacy( bench::State &state )
+{
+    string expr = digitExpression(state.arg(), 1);
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        bench::doNotOptimize(legacyEvaluate(expr.c_str()));
+}
+BENCHMARK_ARG( BM_EvaluateLegacy, 10 );
+BENCHMARK_ARG( BM_EvaluateLegacy, 10000 );
+BENCHMARK_ARG( BM_EvaluateLegacy, 1000000 );
@@ -0,0 +1,41 @@
+// Homework 2 Benchmarks
+// Times the Homework 2 evaluator, which reads tokens straight out of
+// the expression's characters, against the one it replaced.
+
+#include <iostream>
+#include <string>
+using namespace std;
+
+#include "benchmark.h"
+#include "generate.h"
+
+#include "evaluate.h"
+
+// the old evaluator, from legacy_evaluate2.cpp
+int legacyEvaluate( const char expression[] );
+
+// evaluate on a flat expression of arg() operands
+void BM_Evaluate( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 0, 1);
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        bench::doNotOptimize(evaluate(expr.c_str()));
+}
+BENCHMARK_ARG( BM_Evaluate, 10 );
+BENCHMARK_ARG( BM_Evaluate, 1000 );
+BENCHMARK_ARG( BM_Evaluate, 10000 );
+BENCHMARK_ARG( BM_Evaluate, 1000000 );
+
+// The evaluator it replaced, on the same input
+// (which takes far too long to try with a million operands)
+void BM_EvaluateLegacy( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 0, 1);
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        bench::doNotOptimize(legacyEvaluate(expr.c_str()));
+}
+BENCHMARK_ARG( BM_EvaluateLegacy, 10 );
+BENCHMARK_ARG( BM_EvaluateLegacy, 1000 );
+BENCHMARK_ARG( BM_EvaluateLegacy, 10000 );
@@ -0,0 +1,57 @@
+// Homework 3 Benchmarks
+// Times the shunting-yard PostfixExpr, both converting an expression
+// and evaluating one already converted, against the linked-list
+// conversion it replaced.
+
+#include <iostream>
+#include <string>
+using namespace std;
+
+#include "benchmark.h"
+#include "generate.h"
+
+#include "postfix.h"
+
+// the old evaluator, from legacy_evaluate3.cpp
+int legacyEvaluate( const char expression[] );
+
+// conversion and one evaluation, as evaluate does,
+// on a flat expression of arg() operands
+void BM_ConvertAndValue( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 0, 1);
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+    {
+        PostfixExpr post(expr.c_str());
+        bench::doNotOptimize(post.value());
+    }
+}
+BENCHMARK_ARG( BM_ConvertAndValue, 10 );
+BENCHMARK_ARG( BM_ConvertAndValue, 10000 );
+BENCHMARK_ARG( BM_ConvertAndValue, 1000000 );
+
+// evaluation alone, of an expression converted once beforehand
+void BM_Value( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 0, 1);
+    PostfixExpr post(expr.c_str());
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        bench::doNotOptimize(post.value());
+}
+BENCHMARK_ARG( BM_Value, 10 );
+BENCHMARK_ARG( BM_Value, 10000 );
+BENCHMARK_ARG( BM_Value, 1000000 );
+
+// the old conversion and evaluation, on the same input
+void BM_EvaluateLegacy( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 0, 1);
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        bench::doNotOptimize(legacyEvaluate(expr.c_str()));
+}
+BENCHMARK_ARG( BM_EvaluateLegacy, 10 );
+BENCHMARK_ARG( BM_EvaluateLegacy, 10000 );
+BENCHMARK_ARG( BM_EvaluateLegacy, 1000000 );
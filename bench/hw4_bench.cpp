@@ -0,0 +1,135 @@
+// Homework 4 Benchmarks
+// Times the Homework 4 postfix pipeline on generated input:
+// converting an infix token list to postfix, and evaluating it,
+// either from the token list or as a PostfixProgram prepared once.
+
+#include <iostream>
+#include <string>
+using namespace std;
+
+#include "benchmark.h"
+#include "generate.h"
+
+#include "tokenlist.h"
+#include "vartree.h"
+#include "postfix.h"
+
+// conversion and evaluation, from evaluate.cpp
+void assignmentToPostfix(ListIterator& infix, TokenList& result);
+int evaluatePostfix(TokenList& t, VarTree& vars);
+
+// defineVariables
+// Helper to give the generated variables v0..v(n-1) some values
+static void defineVariables( VarTree &vars, int count )
+{
+    for (int i = 0; i < count; ++i)
+        vars.assign(variableName(i), i + 1);
+}
+
+// assignmentToPostfix on a random expression of arg() operands
+void BM_ConvertToPostfix( bench::State &state )
+{
+    string expr = randomExpression(state.arg(), 32, 10, 1);
+    TokenList list(expr.c_str());
+    while (state.keepRunning())
+    {
+        TokenList postfix;
+        ListIterator iter = list.begin();
+        assignmentToPostfix(iter, postfix);
+        bench::doNotOptimize(postfix);
+    }
+}
+BENCHMARK_ARG( BM_ConvertToPostfix, 10 );
+BENCHMARK_ARG( BM_ConvertToPostfix, 1000 );
+
+// evaluatePostfix on a converted expression of arg() operands
+void BM_EvaluatePostfix( bench::State &state )
+{
+    string expr = randomExpression(state.arg(), 32, 10, 2);
+    VarTree vars;
+    defineVariables(vars, 10);
+    TokenList list(expr.c_str()), postfix;
+    ListIterator iter = list.begin();
+    assignmentToPostfix(iter, postfix);
+    state.setItemsPerIteration(state.arg());
+    streambuf *saved = cout.rdbuf(NULL);    // hide any overflow reports
+    while (state.keepRunning())
+        bench::doNotOptimize(evaluatePostfix(postfix, vars));
+    cout.rdbuf(saved);
+    cout.clear();
+}
+BENCHMARK_ARG( BM_EvaluatePostfix, 10 );
+BENCHMARK_ARG( BM_EvaluatePostfix, 1000 );
+
+// evaluatePostfix on a flat expression with many variable operands
+void BM_EvaluatePostfixVariables( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 100, 3);
+    VarTree vars;
+    defineVariables(vars, 100);
+    TokenList list(expr.c_str()), postfix;
+    ListIterator iter = list.begin();
+    assignmentToPostfix(iter, postfix);
+    state.setItemsPerIteration(state.arg());
+    streambuf *saved = cout.rdbuf(NULL);    // hide any overflow reports
+    while (state.keepRunning())
+        bench::doNotOptimize(evaluatePostfix(postfix, vars));
+    cout.rdbuf(saved);
+    cout.clear();
+}
+BENCHMARK_ARG( BM_EvaluatePostfixVariables, 1000 );
+
+// evaluatePostfix on a sum that never overflows, so that under
+// -DCHECKED only the cost of the checks is measured
+void BM_EvaluatePostfixSums( bench::State &state )
+{
+    string expr = sumExpression(state.arg(), 10, 4);
+    VarTree vars;
+    defineVariables(vars, 10);
+    TokenList list(expr.c_str()), postfix;
+    ListIterator iter = list.begin();
+    assignmentToPostfix(iter, postfix);
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        bench::doNotOptimize(evaluatePostfix(postfix, vars));
+}
+BENCHMARK_ARG( BM_EvaluatePostfixSums, 1000 );
+
+// PostfixProgram::run on a program prepared once beforehand
+void BM_RunProgram( bench::State &state )
+{
+    string expr = randomExpression(state.arg(), 32, 10, 2);
+    VarTree vars;
+    defineVariables(vars, 10);
+    TokenList list(expr.c_str()), postfix;
+    ListIterator iter = list.begin();
+    assignmentToPostfix(iter, postfix);
+    PostfixProgram program(postfix, vars);
+    state.setItemsPerIteration(state.arg());
+    streambuf *saved = cout.rdbuf(NULL);    // hide any overflow reports
+    while (state.keepRunning())
+        bench::doNotOptimize(program.run());
+    cout.rdbuf(saved);
+    cout.clear();
+}
+BENCHMARK_ARG( BM_RunProgram, 10 );
+BENCHMARK_ARG( BM_RunProgram, 1000 );
+
+// the same, with many variable operands
+void BM_RunProgramVariables( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 100, 3);
+    VarTree vars;
+    defineVariables(vars, 100);
+    TokenList list(expr.c_str()), postfix;
+    ListIterator iter = list.begin();
+    assignmentToPostfix(iter, postfix);
+    PostfixProgram program(postfix, vars);
+    state.setItemsPerIteration(state.arg());
+    streambuf *saved = cout.rdbuf(NULL);    // hide any overflow reports
+    while (state.keepRunning())
+        bench::doNotOptimize(program.run());
+    cout.rdbuf(saved);
+    cout.clear();
+}
+BENCHMARK_ARG( BM_RunProgramVariables, 1000 );
@@ -0,0 +1,711 @@
+// Homework 7 Benchmarks
+// Times each stage of the Homework 7 pipeline on generated input:
+// tokenizing, parsing into a tree, evaluating the tree, the
+// variable symbol table, and compiling to and running on the machine,
+// as bytecode, or as dc code.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+using namespace std;
+
+#include "benchmark.h"
+#include "generate.h"
+
+#include "tokenlist.h"
+#include "lexer.h"
+#include "exprtree.h"
+#include "vartree.h"
+#include "funmap.h"
+#include "machine.h"
+#include "compile.h"
+#include "dc.h"
+#include "bytecode.h"
+#include "sink.h"
+
+// the old tokenizer, from legacy_tokenize.cpp
+void legacyTokenize( const char expr[], TokenList &list );
+
+// parser entry point, from compile.cpp
+ExprNode* assignmentToTree (Lexer& infix, FunctionDef& funs, NodeArena& arena);
+
+// defineVariables
+// Helper to give the generated variables v0..v(n-1) some values
+static void defineVariables( VarTree &vars, int count )
+{
+    for (int i = 0; i < count; ++i)
+        vars.assign(variableName(i), i + 1);
+}
+
+// TokenList(const char[]) on a flat expression of arg() operands
+void BM_Tokenize( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 10, 1);
+    state.setItemsPerIteration(2 * state.arg() - 1);
+    while (state.keepRunning())
+    {
+        TokenList list(expr.c_str());
+        bench::doNotOptimize(list);
+    }
+}
+BENCHMARK_ARG( BM_Tokenize, 10 );
+BENCHMARK_ARG( BM_Tokenize, 1000 );
+BENCHMARK_ARG( BM_Tokenize, 500000 );    // about 3 megabytes
+
+// The character-at-a-time tokenizer it replaced, on the same input
+void BM_TokenizeLegacy( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 10, 1);
+    state.setItemsPerIteration(2 * state.arg() - 1);
+    while (state.keepRunning())
+    {
+        TokenList list;
+        legacyTokenize(expr.c_str(), list);
+        bench::doNotOptimize(list);
+    }
+}
+BENCHMARK_ARG( BM_TokenizeLegacy, 10 );
+BENCHMARK_ARG( BM_TokenizeLegacy, 1000 );
+BENCHMARK_ARG( BM_TokenizeLegacy, 500000 );
+
+// Pulling every token from a Lexer, on the same input
+void BM_Lex( bench::State &state )
+{
+    string expr = flatExpression(state.arg(), 10, 1);
+    state.setItemsPerIteration(2 * state.arg() - 1);
+    while (state.keepRunning())
+    {
+        Lexer lex(expr.c_str());
+        while (!lex.done())
+            lex.advance();
+        bench::doNotOptimize(lex.token());
+    }
+}
+BENCHMARK_ARG( BM_Lex, 10 );
+BENCHMARK_ARG( BM_Lex, 1000 );
+BENCHMARK_ARG( BM_Lex, 500000 );
+
+// assignmentToTree on a random expression of arg() operands,
+// pulling its tokens from a Lexer
+void BM_Parse( bench::State &state )
+{
+    string expr = randomExpression(state.arg(), 32, 10, 2);
+    FunctionDef funs;
+    NodeArena arena;
+    while (state.keepRunning())
+    {
+        Lexer lex(expr.c_str());
+        bench::doNotOptimize(assignmentToTree(lex, funs, arena));
+        arena.release();
+    }
+}
+BENCHMARK_ARG( BM_Parse, 10 );
+BENCHMARK_ARG( BM_Parse, 1000 );
+
+// assignmentToTree on an expression nested arg() parentheses deep
+void BM_ParseNested( bench::State &state )
+{
+    string expr = nestedExpression(state.arg(), 3);
+    FunctionDef funs;
+    NodeArena arena;
+    while (state.keepRunning())
+    {
+        Lexer lex(expr.c_str());
+        bench::doNotOptimize(assignmentToTree(lex, funs, arena));
+        arena.release();
+    }
+}
+BENCHMARK_ARG( BM_ParseNested, 100 );
+
+// ExprNode::evaluate on a random tree of arg() operands
+void BM_TreeEvaluate( bench::State &state )
+{
+    string expr = randomExpression(state.arg(), 32, 10, 4);
+    VarTree vars;
+    FunctionDef funs;
+    NodeArena arena;
+    defineVariables(vars, 10);
+    Lexer lex(expr.c_str());
+    ExprNode *root = assignmentToTree(lex, funs, arena);
+    state.setItemsPerIteration(state.arg());
+    streambuf *saved = cout.rdbuf(NULL);    // hide any overflow reports
+    while (state.keepRunning())
+        bench::doNotOptimize(root->evaluate(vars, funs));
+    cout.rdbuf(saved);
+    cout.clear();
+}
+BENCHMARK_ARG( BM_TreeEvaluate, 10 );
+BENCHMARK_ARG( BM_TreeEvaluate, 1000 );
+
+// ExprNode::toString of a random tree of arg() operands
+// (so 2 * arg() - 1 nodes)
+void BM_ToString( bench::State &state )
+{
+    string expr = randomExpression(state.arg(), 32, 10, 4);
+    FunctionDef funs;
+    NodeArena arena;
+    Lexer lex(expr.c_str());
+    ExprNode *root = assignmentToTree(lex, funs, arena);
+    state.setItemsPerIteration(2 * state.arg() - 1);
+    while (state.keepRunning())
+        bench::doNotOptimize(root->toString());
+}
+BENCHMARK_ARG( BM_ToString, 1000 );
+BENCHMARK_ARG( BM_ToString, 500000 );   // a million nodes
+
+// ExprNode::makedc of the same tree
+void BM_Makedc( bench::State &state )
+{
+    string expr = randomExpression(state.arg(), 32, 10, 4);
+    FunctionDef funs;
+    NodeArena arena;
+    Lexer lex(expr.c_str());
+    ExprNode *root = assignmentToTree(lex, funs, arena);
+    state.setItemsPerIteration(2 * state.arg() - 1);
+    while (state.keepRunning())
+    {
+        DcProgram program;
+        bench::doNotOptimize(root->makedc(program));
+    }
+}
+BENCHMARK_ARG( BM_Makedc, 1000 );
+BENCHMARK_ARG( BM_Makedc, 500000 );
+
+// ExprNode::evaluate on a sum that never overflows, so that under
+// -DCHECKED only the cost of the checks is measured
+void BM_TreeEvaluateSums( bench::State &state )
+{
+    string expr = sumExpression(state.arg(), 10, 4);
+    VarTree vars;
+    FunctionDef funs;
+    NodeArena arena;
+    defineVariables(vars, 10);
+    Lexer lex(expr.c_str());
+    ExprNode *root = assignmentToTree(lex, funs, arena);
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        bench::doNotOptimize(root->evaluate(vars, funs));
+}
+BENCHMARK_ARG( BM_TreeEvaluateSums, 1000 );
+
+// ExprNode::evaluate of fact(arg()), a recursive function whose
+// values soon outgrow an int (and, under VALUE_BIGNUM, a long long)
+void BM_Factorial( bench::State &state )
+{
+    static Instruction *program[100];
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    compile("deffn fact(n)=n<=1?1:n*fact(n-1)", vars, funs, program, progBegin, progEnd);
+
+    NodeArena arena;
+    string call = "fact(" + to_string(state.arg()) + ")";
+    Lexer lex(call.c_str());
+    ExprNode *root = assignmentToTree(lex, funs, arena);
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        bench::doNotOptimize(root->evaluate(vars, funs));
+}
+BENCHMARK_ARG( BM_Factorial, 12 );      // the largest that fits an int
+#if defined(VALUE_INT64) || defined(VALUE_BIGNUM)
+BENCHMARK_ARG( BM_Factorial, 20 );      // the largest that fits a long long
+#endif
+#if defined(VALUE_BIGNUM)
+BENCHMARK_ARG( BM_Factorial, 100 );
+#endif
+
+// VarTree::lookup in a table of arg() variables
+void BM_VarTreeLookup( bench::State &state )
+{
+    VarTree vars;
+    defineVariables(vars, state.arg());
+    Random random(5);
+    string names[64];
+    for (int i = 0; i < 64; ++i)
+        names[i] = variableName(random.next(state.arg()));
+    int i = 0;
+    while (state.keepRunning())
+        bench::doNotOptimize(vars.lookup(names[i++ & 63]));
+}
+BENCHMARK_ARG( BM_VarTreeLookup, 10 );
+BENCHMARK_ARG( BM_VarTreeLookup, 10000 );
+
+// VarTree::assign to existing variables in a table of arg() variables
+void BM_VarTreeAssign( bench::State &state )
+{
+    VarTree vars;
+    defineVariables(vars, state.arg());
+    Random random(6);
+    string names[64];
+    for (int i = 0; i < 64; ++i)
+        names[i] = variableName(random.next(state.arg()));
+    int i = 0;
+    while (state.keepRunning())
+    {
+        vars.assign(names[i & 63], i);
+        ++i;
+    }
+}
+BENCHMARK_ARG( BM_VarTreeAssign, 10 );
+BENCHMARK_ARG( BM_VarTreeAssign, 10000 );
+
+// compile() of one line of arg() operands, then running the machine
+void BM_CompileExecute( bench::State &state )
+{
+    const int CODE = 100000, STACK = 1000, TEMPS = 100000;
+    string expr = "v0 = " + randomExpression(state.arg(), 32, 10, 7);
+    static Instruction *program[CODE];
+    static Integer stack[STACK], temps[TEMPS];
+    streambuf *saved = cout.rdbuf(NULL);    // hide the printed results
+    while (state.keepRunning())
+    {
+        VarTree vars;
+        FunctionDef funs;
+        int progBegin = -1, progEnd = 0;
+        compile(expr.c_str(), vars, funs, program, progBegin, progEnd);
+
+        int stackPointer = STACK - vars.size();
+        int programCounter = progBegin;
+        while (programCounter < progEnd)
+        {
+            programCounter++;
+            program[programCounter-1]->execute(temps, stack, stackPointer, programCounter);
+        }
+
+        for (int i = 0; i < progEnd; ++i)
+            delete program[i];
+    }
+    cout.rdbuf(saved);
+    cout.clear();
+}
+BENCHMARK_ARG( BM_CompileExecute, 10 );
+BENCHMARK_ARG( BM_CompileExecute, 1000 );
+
+// executeLine
+// Compiles one line, with or without superinstructions, and times
+// running it on the machine; an item is one instruction dispatched
+static void executeLine( bench::State &state, const string &expr, bool fuse )
+{
+    const int CODE = 100000, STACK = 1000, TEMPS = 100000;
+    static Instruction *program[CODE];
+    static Integer stack[STACK], temps[TEMPS];
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    superinstructions = fuse;
+    compile(expr.c_str(), vars, funs, program, progBegin, progEnd);
+    superinstructions = true;
+    progEnd--;                              // leave off the final print
+
+    state.setItemsPerIteration(progEnd);
+    streambuf *saved = cout.rdbuf(NULL);    // hide any overflow reports
+    while (state.keepRunning())
+    {
+        int stackPointer = STACK - vars.size();
+        int programCounter = progBegin;
+        while (programCounter < progEnd)
+        {
+            programCounter++;
+            program[programCounter-1]->execute(temps, stack, stackPointer, programCounter);
+        }
+    }
+    cout.rdbuf(saved);
+    cout.clear();
+    for (int i = 0; i <= progEnd; ++i)
+        delete program[i];
+}
+
+// Running an already compiled line of arg() operands on the machine
+void BM_Execute( bench::State &state )
+{
+    executeLine(state, "v0 = " + randomExpression(state.arg(), 32, 10, 8), true);
+}
+BENCHMARK_ARG( BM_Execute, 10 );
+BENCHMARK_ARG( BM_Execute, 1000 );
+
+// The same, without superinstructions
+void BM_ExecuteUnfused( bench::State &state )
+{
+    executeLine(state, "v0 = " + randomExpression(state.arg(), 32, 10, 8), false);
+}
+BENCHMARK_ARG( BM_ExecuteUnfused, 10 );
+BENCHMARK_ARG( BM_ExecuteUnfused, 1000 );
+
+// counterExpression
+// A sum of increments and decrements of ten variables, like
+// "(v0 = v0 + 1) + (v1 = v1 + 1) + ... + (v0 = v0 - 1) + ...",
+// which leaves them as they were, so that nothing ever overflows
+static string counterExpression( int terms )
+{
+    string expr = variableName(10) + " = 0";
+    for (int i = 0; i < terms; ++i)
+        expr += " + (" + variableName(i % 10) + " = " + variableName(i % 10)
+            + (i / 10 % 2 == 0 ? " + 1)" : " - 1)");
+    return expr;
+}
+
+// Running the increments, which become AddImmToStack
+void BM_ExecuteCounters( bench::State &state )
+{
+    executeLine(state, counterExpression(state.arg()), true);
+}
+BENCHMARK_ARG( BM_ExecuteCounters, 1000 );
+
+void BM_ExecuteCountersUnfused( bench::State &state )
+{
+    executeLine(state, counterExpression(state.arg()), false);
+}
+BENCHMARK_ARG( BM_ExecuteCountersUnfused, 1000 );
+
+// Running the same line as dc code, in the DcMachine
+void BM_ExecuteDc( bench::State &state )
+{
+    static Instruction *program[100000];
+    string expr = "v0 = " + randomExpression(state.arg(), 32, 10, 8);
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    DcProgram dcProgram;
+    compile(expr.c_str(), vars, funs, program, progBegin, progEnd, -1, NULL, &dcProgram);
+    string code = dcPrelude() + dcProgram.code;
+    code.erase(code.size() - 4, 1);         // leave off the final print
+
+    DcMachine dc;
+    streambuf *saved = cout.rdbuf(NULL);    // hide any overflow reports
+    while (state.keepRunning())
+        dc.run(code);
+    cout.rdbuf(saved);
+    cout.clear();
+    bench::doNotOptimize(dc.top());
+}
+BENCHMARK_ARG( BM_ExecuteDc, 10 );
+BENCHMARK_ARG( BM_ExecuteDc, 1000 );
+
+// runBytecode
+// Times running a program compiled to bytecode, with the results it
+// prints collected (and thrown away) rather than written
+static void runBytecode( bench::State &state, Bytecode &code, int globals )
+{
+    CollectorSink results;
+    ResultSink *savedSink = resultSink;
+    resultSink = &results;
+    streambuf *saved = cout.rdbuf(NULL);    // hide any overflow reports
+    while (state.keepRunning())
+    {
+        code.run(globals);
+        results.clear();
+    }
+    cout.rdbuf(saved);
+    cout.clear();
+    resultSink = savedSink;
+}
+
+// Running the same line as bytecode, on the stack machine
+void BM_ExecuteBytecode( bench::State &state )
+{
+    static Instruction *program[100000];
+    string expr = "v0 = " + randomExpression(state.arg(), 32, 10, 8);
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    Bytecode code;
+    compile(expr.c_str(), vars, funs, program, progBegin, progEnd, -1, NULL, NULL, &code);
+    for (int i = 0; i < progEnd; ++i)
+        delete program[i];
+    runBytecode(state, code, vars.size());
+}
+BENCHMARK_ARG( BM_ExecuteBytecode, 10 );
+BENCHMARK_ARG( BM_ExecuteBytecode, 1000 );
+
+// Generating the machine's code for a parsed line of arg() operands;
+// the bytes per iteration are what its instructions take
+void BM_CodegenMachine( bench::State &state )
+{
+    static Instruction *program[100000];
+    string expr = "v0 = " + randomExpression(state.arg(), 32, 10, 8);
+    VarTree vars;
+    FunctionDef funs;
+    NodeArena arena;
+    Lexer lex(expr.c_str());
+    ExprNode *root = assignmentToTree(lex, funs, arena);
+    while (state.keepRunning())
+    {
+        int progEnd = 0, tempCounter = 0;
+        root->toInstruction(program, progEnd, tempCounter, vars, funs, false);
+        for (int i = 0; i < progEnd; ++i)
+            delete program[i];
+    }
+}
+BENCHMARK_ARG( BM_CodegenMachine, 1000 );
+
+// The same line as bytecode; the bytes per iteration include what
+// the code vector dropped as it grew, about as much again
+void BM_CodegenBytecode( bench::State &state )
+{
+    string expr = "v0 = " + randomExpression(state.arg(), 32, 10, 8);
+    VarTree vars;
+    FunctionDef funs;
+    NodeArena arena;
+    Lexer lex(expr.c_str());
+    ExprNode *root = assignmentToTree(lex, funs, arena);
+    while (state.keepRunning())
+    {
+        Bytecode code;
+        code.addLine(*root, vars, funs, -1);
+        bench::doNotOptimize(code.size());
+    }
+}
+BENCHMARK_ARG( BM_CodegenBytecode, 1000 );
+
+// Running a compiled sum that never overflows, so that under
+// -DCHECKED only the cost of the checks is measured
+void BM_ExecuteSums( bench::State &state )
+{
+    const int CODE = 100000, STACK = 1000, TEMPS = 100000;
+    string expr = "v0 = " + sumExpression(state.arg(), 0, 4);
+    static Instruction *program[CODE];
+    static Integer stack[STACK], temps[TEMPS];
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    compile(expr.c_str(), vars, funs, program, progBegin, progEnd);
+    progEnd--;                              // leave off the final print
+
+    state.setItemsPerIteration(progEnd);
+    while (state.keepRunning())
+    {
+        int stackPointer = STACK - vars.size();
+        int programCounter = progBegin;
+        while (programCounter < progEnd)
+        {
+            programCounter++;
+            program[programCounter-1]->execute(temps, stack, stackPointer, programCounter);
+        }
+    }
+}
+BENCHMARK_ARG( BM_ExecuteSums, 1000 );
+
+// printResults
+// Runs a Print instruction arg() times, on a different value each
+// time, with the results going to a sink
+static void printResults( bench::State &state, ResultSink &sink )
+{
+    Print print(0);
+    Integer temps[1];
+    int stackPointer = 0, programCounter = 0;
+    ResultSink *saved = resultSink;
+    resultSink = &sink;
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+    {
+        for (int i = 0; i < state.arg(); ++i)
+        {
+            temps[0] = i * 7919;
+            print.execute(temps, NULL, stackPointer, programCounter);
+        }
+        sink.flush();
+    }
+    resultSink = saved;
+}
+
+// Print as it was, writing each result with endl, to /dev/null
+// (so that only the flushes' system calls are left to time)
+void BM_PrintEndl( bench::State &state )
+{
+    ofstream null("/dev/null");
+    Integer value = 0;
+    state.setItemsPerIteration(state.arg());
+    while (state.keepRunning())
+        for (int i = 0; i < state.arg(); ++i)
+        {
+            value = i * 7919;
+            null << value << endl;
+        }
+}
+BENCHMARK_ARG( BM_PrintEndl, 100000 );
+
+// Print through a TextSink, flushed once at the end
+void BM_PrintText( bench::State &state )
+{
+    ofstream null("/dev/null");
+    TextSink sink(null, false);
+    printResults(state, sink);
+}
+BENCHMARK_ARG( BM_PrintText, 100000 );
+
+// Print through a BinarySink of 32-bit integers
+void BM_PrintBinary( bench::State &state )
+{
+    ofstream null("/dev/null", ios::binary);
+    BinarySink sink(null, 32);
+    printResults(state, sink);
+}
+BENCHMARK_ARG( BM_PrintBinary, 100000 );
+
+// Print into a CollectorSink, which is emptied each time round
+// (when printResults flushes it), once its room has been made
+class ReusedCollector : public CollectorSink
+{
+    public:
+        void flush() { clear(); }
+};
+
+void BM_PrintCollect( bench::State &state )
+{
+    ReusedCollector sink;
+    printResults(state, sink);
+    bench::doNotOptimize(sink.results().size());
+}
+BENCHMARK_ARG( BM_PrintCollect, 100000 );
+
+static const char FIB[] = "deffn fib(n)=n<2?n:fib(n-1)+fib(n-2)";
+
+// ExprNode::evaluate of fib(arg()), with a VarTree for every call
+void BM_FibTree( bench::State &state )
+{
+    static Instruction *program[100];
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    compile(FIB, vars, funs, program, progBegin, progEnd);
+
+    NodeArena arena;
+    string call = "fib(" + to_string(state.arg()) + ")";
+    Lexer lex(call.c_str());
+    ExprNode *root = assignmentToTree(lex, funs, arena);
+    while (state.keepRunning())
+        bench::doNotOptimize(root->evaluate(vars, funs));
+}
+BENCHMARK_ARG( BM_FibTree, 20 );
+
+// ExprNode::evaluate of a call to one of arg() functions defined,
+// which the call was bound to when it was parsed
+void BM_TreeCallAmong( bench::State &state )
+{
+    static Instruction *program[10000];
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    for (int i = 0; i < state.arg(); ++i)
+    {
+        string def = "deffn " + variableName(i) + "(x) = x + " + to_string(i);
+        compile(def.c_str(), vars, funs, program, progBegin, progEnd);
+    }
+
+    NodeArena arena;
+    string call = variableName(state.arg() / 2) + "(1)";
+    Lexer lex(call.c_str());
+    ExprNode *root = assignmentToTree(lex, funs, arena);
+    while (state.keepRunning())
+        bench::doNotOptimize(root->evaluate(vars, funs));
+}
+BENCHMARK_ARG( BM_TreeCallAmong, 1 );
+BENCHMARK_ARG( BM_TreeCallAmong, 1000 );
+
+// The same, compiled and run on the machine, with a stack frame
+// for every call
+void BM_FibMachine( bench::State &state )
+{
+    const int CODE = 100, STACK = 10000, TEMPS = 100;
+    static Instruction *program[CODE];
+    static Integer stack[STACK], temps[TEMPS];
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    compile(FIB, vars, funs, program, progBegin, progEnd);
+    string call = "r = fib(" + to_string(state.arg()) + ")";
+    compile(call.c_str(), vars, funs, program, progBegin, progEnd);
+    progEnd--;                              // leave off the final print
+
+    while (state.keepRunning())
+    {
+        int stackPointer = STACK - vars.size();
+        int programCounter = progBegin;
+        while (programCounter < progEnd)
+        {
+            programCounter++;
+            program[programCounter-1]->execute(temps, stack, stackPointer, programCounter);
+        }
+    }
+    bench::doNotOptimize(stack[0]);
+}
+BENCHMARK_ARG( BM_FibMachine, 20 );
+
+// The same, as dc code, with a macro for the function
+void BM_FibDc( bench::State &state )
+{
+    static Instruction *program[100];
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    DcProgram dcProgram;
+    compile(FIB, vars, funs, program, progBegin, progEnd, -1, NULL, &dcProgram);
+    string call = "r = fib(" + to_string(state.arg()) + ")";
+    compile(call.c_str(), vars, funs, program, progBegin, progEnd, -1, NULL, &dcProgram);
+    string code = dcPrelude() + dcProgram.code;
+    code.erase(code.size() - 4, 1);         // leave off the final print
+
+    DcMachine dc;
+    while (state.keepRunning())
+        dc.run(code);
+    bench::doNotOptimize(dc.top());
+}
+BENCHMARK_ARG( BM_FibDc, 20 );
+
+// The same, as bytecode, on the stack machine
+void BM_FibBytecode( bench::State &state )
+{
+    static Instruction *program[100];
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    Bytecode code;
+    compile(FIB, vars, funs, program, progBegin, progEnd, -1, NULL, NULL, &code);
+    string call = "r = fib(" + to_string(state.arg()) + ")";
+    compile(call.c_str(), vars, funs, program, progBegin, progEnd, -1, NULL, NULL, &code);
+    runBytecode(state, code, vars.size());
+}
+BENCHMARK_ARG( BM_FibBytecode, 20 );
+
+static const char *SMALL_FUNCTIONS[] = {
+    "deffn three() = 3", "deffn sqr(x) = x * x", "deffn add(a, b) = a + b"
+};
+
+// The machine running 100 lines that call the small functions above,
+// compiled with (arg 1) and without (arg 0) inlining and constant folding
+void BM_SmallCalls( bench::State &state )
+{
+    const int CODE = 10000, STACK = 1000, TEMPS = 100;
+    static Instruction *program[CODE];
+    static Integer stack[STACK], temps[TEMPS];
+    VarTree vars;
+    FunctionDef funs;
+    int progBegin = -1, progEnd = 0;
+    optimizeTrees = state.arg() != 0;
+    for (int i = 0; i < 3; ++i)
+        compile(SMALL_FUNCTIONS[i], vars, funs, program, progBegin, progEnd);
+    compile("Three = 5", vars, funs, program, progBegin, progEnd);
+    progEnd--;                              // leave off each print
+    for (int i = 0; i < 100; ++i)
+    {
+        compile("r = three() * 9 + Three", vars, funs, program, progBegin, progEnd);
+        progEnd--;
+        compile("r = add(sqr(Three), r)", vars, funs, program, progBegin, progEnd);
+        progEnd--;
+    }
+    optimizeTrees = true;
+
+    while (state.keepRunning())
+    {
+        int stackPointer = STACK - vars.size();
+        int programCounter = progBegin;
+        while (programCounter < progEnd)
+        {
+            programCounter++;
+            program[programCounter-1]->execute(temps, stack, stackPointer, programCounter);
+        }
+    }
+    bench::doNotOptimize(stack[STACK - 1]);
+}
+BENCHMARK_ARG( BM_SmallCalls, 0 );
+BENCHMARK_ARG( BM_SmallCalls, 1 );
@@ -0,0 +1,80 @@
+// Legacy Tokenizer
+// The character-at-a-time TokenList constructor that Homework 6 and 7
+// used before the table-driven scanner, kept only so the benchmarks
+// can compare the two.  It fills an empty list given to it.
+
+#include <string>
+#include <ctype.h>
+#include <stdlib.h>
+using namespace std;
+
+#include "tokenlist.h"
+
+static bool legacyIsOperator(char c);
+
+// legacyTokenize
+// converts a character string into a list of tokens, as the old
+// TokenList constructor did
+// Parameters:
+//     expr    (input char pointer)    string to examine
+//     list    (modified TokenList)    empty list to fill
+void legacyTokenize( const char expr[], TokenList &list )
+{
+    int position = 0;
+
+    //Go past any initial spaces
+    while (expr[position] == ' ')
+        ++position;
+
+    //Go until we hit a null character
+    while (expr[position] != '\0')
+    {
+        if (isdigit(expr[position]))
+        {
+            Token t((Integer) atoi(&expr[position]));
+            list.push_back(t);
+            while (isdigit(expr[position]))
+                ++position;
+        }
+        else if (legacyIsOperator(expr[position]))
+        {
+            string charstring;
+            charstring += expr[position];
+            ++position;
+
+            //This next bit will take care of 2 character operations (>=, <=, !=, ==)
+            //I have this rather than a while loop to keep the program from swallowing long strings
+            //of operators, such as in A=(B+C), where =( would be treated as one operator.
+            if (expr[position] == '=' && expr[position - 1] != ')')
+            {
+                charstring += expr[position];
+                ++position;
+            }
+
+            Token t(charstring);
+            list.push_back(t);
+        }
+        else
+        {
+            string charstring;
+            while (expr[position] != ' ' && expr[position] != '\0' && !legacyIsOperator(expr[position]))
+            {
+                charstring += expr[position];
+                ++position;
+            }
+            Token t(charstring);
+            list.push_back(t);
+        }
+
+        //Advance to next token if we're on spaces
+        while (expr[position] == ' ')
+            ++position;
+    }
+}
+
+static bool legacyIsOperator(char c)
+{
+    return (c == '+' || c == '-' || c == '*' || c == '/' || c == '%' || 
+            c == '(' || c == ')' || c == '=' || c == ',' || c == '<' ||
+            c == '>' || c == '!' || c == '?' || c == ':');
+}
@@ -0,0 +1,302 @@
+// Script Generator
+// Writes a large, valid script in the homework grammar, for use as
+// benchmark input and as a correctness test for the later homeworks.
+//
+// The script mixes random and deeply nested arithmetic, chains of
+// assignments, ?: conditionals, relational tests, and deffn function
+// definitions and calls (including recursive ones).  Every line is
+// also run through the Homework 6 tree evaluator, and the value of
+// each line that is not a deffn is written to a second file, one per
+// line, in the same order the Homework 7 machine prints its results.
+//
+// The values are kept well within the range of an int: every variable
+// is assigned modulo a small prime, and a product is only generated
+// when its operands are known to be small enough.
+//
+// Usage:
+//     scriptgen [options] script expected
+// Options (all take a number):
+//     -lines      lines in the script, not counting deffns  (1000)
+//     -terms      operands in the largest expression        (20)
+//     -depth      deepest nesting of operators               (8)
+//     -vars       distinct variables                         (26)
+//     -functions  ordinary functions to define               (4)
+//     -recursion  recursive functions, each called with an
+//                 argument below this limit                  (20)
+//     -seed       random seed                                (1)
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string.h>
+#include <stdlib.h>
+using namespace std;
+
+#include "generate.h"
+#include "evaluate.h"
+
+const int MODULUS = 1009;           // every assigned value is below this
+const long long LIMIT = 1 << 30;    // largest magnitude any expression may reach
+
+// number
+// Helper to write a number as text
+static string number( long long n )
+{
+    ostringstream text;
+    text << n;
+    return text.str();
+}
+
+struct Settings
+{
+    int lines, terms, depth, vars, functions, recursion;
+    unsigned seed;
+};
+
+// A piece of generated expression, and the most it can be in magnitude
+struct Piece
+{
+    string text;
+    long long bound;
+    int precedence;     // 1 for + and -, 2 for * / %, 3 for an operand
+};
+
+class ScriptBuilder
+{
+    private:
+        Random random;
+        Settings settings;
+        int params;             // parameters in the function being defined
+        long long paramBound;   // largest value a parameter may hold
+
+        Piece operand();
+        Piece expression( int terms, int depth );
+        string relation();
+        string wrapped( int terms );
+        string call();
+    public:
+        ScriptBuilder( const Settings &s ) : random(s.seed), settings(s)
+        {
+            params = 0;
+            paramBound = 0;
+        }
+        string function( int index );
+        string recursiveFunction( int index );
+        string line();
+};
+
+// operand
+// A literal, a variable, or (inside a function) a parameter
+Piece ScriptBuilder::operand()
+{
+    Piece p;
+    ostringstream text;
+    int kind = random.next(3);
+    if (params > 0 && kind != 0)
+    {
+        text << variableName(random.next(params));
+        p.bound = paramBound;
+    }
+    else if (params == 0 && kind == 1 && settings.vars > 0)
+    {
+        text << variableName(random.next(settings.vars));
+        p.bound = MODULUS - 1;
+    }
+    else
+    {
+        text << 1 + random.next(99);
+        p.bound = 99;
+    }
+    p.text = text.str();
+    p.precedence = 3;
+    return p;
+}
+
+// expression
+// A random arithmetic expression of about the given number of
+// operands, whose value is known not to exceed LIMIT
+Piece ScriptBuilder::expression( int terms, int depth )
+{
+    if (terms <= 1 || depth <= 0)
+        return operand();
+
+    int leftTerms = 1 + random.next(terms - 1);
+    Piece left = expression(leftTerms, depth - 1);
+    int choice = random.next(5);
+
+    Piece result;
+    if (choice >= 3)        // divide or mod by a small literal
+    {
+        int divisor = 1 + random.next(9);
+        ostringstream text;
+        text << (left.precedence < 2 ? "(" + left.text + ")" : left.text)
+             << (choice == 3 ? "/" : "%") << divisor;
+        result.text = text.str();
+        result.bound = left.bound;
+        result.precedence = 2;
+        return result;
+    }
+
+    Piece right = expression(terms - leftTerms, depth - 1);
+    char oper = choice == 0 ? '+' : choice == 1 ? '-' : '*';
+    if (oper == '*' && left.bound * right.bound > LIMIT)
+        oper = '+';
+    if (oper != '*' && left.bound + right.bound > LIMIT)
+        return left;
+
+    int precedence = oper == '*' ? 2 : 1;
+    result.text = (left.precedence < precedence ? "(" + left.text + ")" : left.text)
+                + oper
+                + (right.precedence <= precedence ? "(" + right.text + ")" : right.text);
+    result.bound = oper == '*' ? left.bound * right.bound : left.bound + right.bound;
+    result.precedence = precedence;
+    return result;
+}
+
+// wrapped
+// An expression reduced modulo MODULUS, suitable for assigning
+string ScriptBuilder::wrapped( int terms )
+{
+    return "(" + expression(terms, settings.depth).text + ")%" + number(MODULUS);
+}
+
+// relation
+// A relational test between two expressions
+string ScriptBuilder::relation()
+{
+    static const char *opers[] = { " < ", " > ", " <= ", " >= ", " == ", " != " };
+    int terms = 1 + random.next(settings.terms / 2 + 1);
+    return "(" + expression(terms, settings.depth).text + ")"
+         + opers[random.next(6)]
+         + "(" + expression(terms, settings.depth).text + ")";
+}
+
+// call
+// A call to one of the defined functions
+string ScriptBuilder::call()
+{
+    ostringstream text;
+    if (settings.recursion > 0 && (settings.functions == 0 || random.next(2) == 0))
+        text << "r" << random.next(2) << "(" << random.next(settings.recursion) << ")";
+    else
+        text << "f" << random.next(settings.functions) << "("
+             << wrapped(1 + random.next(3)) << "," << wrapped(1 + random.next(3)) << ")";
+    return text.str();
+}
+
+// function
+// Defines fN(v0,v1) as a random expression of its parameters
+string ScriptBuilder::function( int index )
+{
+    ostringstream text;
+    params = 2;
+    paramBound = MODULUS - 1;
+    text << "deffn f" << index << "(v0,v1)=" << wrapped(settings.terms / 2 + 1);
+    params = 0;
+    return text.str();
+}
+
+// recursiveFunction
+// Defines rN(v0) as a sum over v0 down to zero of a random expression
+string ScriptBuilder::recursiveFunction( int index )
+{
+    ostringstream text;
+    params = 1;
+    paramBound = settings.recursion;
+    text << "deffn r" << index << "(v0)=v0 <= 0 ? " << 1 + random.next(9)
+         << " : " << wrapped(3) << "+r" << index << "(v0-1)";
+    params = 0;
+    return text.str();
+}
+
+// line
+// One line of the script that produces a value
+string ScriptBuilder::line()
+{
+    bool calls = settings.functions > 0 || settings.recursion > 0;
+    string target = variableName(random.next(settings.vars));
+    int terms = 1 + random.next(settings.terms);
+
+    switch (random.next(calls ? 7 : 6))
+    {
+    case 0:         // deep arithmetic
+        return target + " = " + wrapped(settings.terms);
+    case 1:         // chain of assignments
+        return target + " = " + variableName(random.next(settings.vars))
+             + " = " + wrapped(terms);
+    case 2:         // conditional
+        return target + " = (" + relation() + ") ? (" + wrapped(terms)
+             + ") : (" + wrapped(terms) + ")";
+    case 3:         // relational test
+        return relation();
+    case 4:         // plain expression, not assigned
+        return expression(terms, settings.depth).text;
+    case 6:         // function call
+        return target + " = (" + call() + ")%" + number(MODULUS);
+    default:        // simple assignment
+        return target + " = " + wrapped(terms);
+    }
+}
+
+int main( int argc, char *argv[] )
+{
+    Settings settings = { 1000, 20, 8, 26, 4, 20, 1 };
+    const char *names[2] = { NULL, NULL };
+    int named = 0;
+
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        if (argv[arg][0] == '-' && arg + 1 < argc)
+        {
+            int value = atoi(argv[arg + 1]);
+            if (strcmp(argv[arg], "-lines") == 0)           settings.lines = value;
+            else if (strcmp(argv[arg], "-terms") == 0)      settings.terms = value;
+            else if (strcmp(argv[arg], "-depth") == 0)      settings.depth = value;
+            else if (strcmp(argv[arg], "-vars") == 0)       settings.vars = value;
+            else if (strcmp(argv[arg], "-functions") == 0)  settings.functions = value;
+            else if (strcmp(argv[arg], "-recursion") == 0)  settings.recursion = value;
+            else if (strcmp(argv[arg], "-seed") == 0)       settings.seed = value;
+            else
+            {
+                cout << "Unknown option " << argv[arg] << endl;
+                return 1;
+            }
+            ++arg;
+        }
+        else if (named < 2)
+            names[named++] = argv[arg];
+    }
+
+    if (named < 2 || settings.vars < 1 || settings.terms < 1)
+    {
+        cout << "Usage: scriptgen [options] script expected" << endl;
+        cout << "    -lines -terms -depth -vars -functions -recursion -seed" << endl;
+        return 1;
+    }
+
+    ofstream script(names[0]), expected(names[1]);
+    ScriptBuilder builder(settings);
+    VarTree vars;
+    FunctionDef funs;
+
+    for (int i = 0; i < settings.functions; ++i)
+    {
+        string text = builder.function(i);
+        evaluate(text.c_str(), vars, funs);
+        script << text << endl;
+    }
+    for (int i = 0; settings.recursion > 0 && i < 2; ++i)
+    {
+        string text = builder.recursiveFunction(i);
+        evaluate(text.c_str(), vars, funs);
+        script << text << endl;
+    }
+
+    for (int i = 0; i < settings.lines; ++i)
+    {
+        string text = builder.line();
+        script << text << endl;
+        expected << evaluate(text.c_str(), vars, funs) << endl;
+    }
+}